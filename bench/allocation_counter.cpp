@@ -0,0 +1,24 @@
+#include "allocation_counter.hpp"
+
+#include <atomic>  // for atomic
+#include <cstdlib>  // for malloc, free
+#include <new>      // for bad_alloc
+
+static std::atomic<std::size_t> allocations{0};
+
+std::size_t allocationCount() { return allocations; }
+
+void* operator new(std::size_t size) {
+  allocations++;
+  if (void* memory = std::malloc(size == 0 ? 1 : size)) return memory;
+  throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size) { return operator new(size); }
+
+void operator delete(void* memory) noexcept { std::free(memory); }
+void operator delete(void* memory, std::size_t) noexcept { std::free(memory); }
+void operator delete[](void* memory) noexcept { std::free(memory); }
+void operator delete[](void* memory, std::size_t) noexcept {
+  std::free(memory);
+}
@@ -0,0 +1,6 @@
+#pragma once
+
+#include <cstddef>  // for size_t
+
+// Number of calls to operator new since the program started
+std::size_t allocationCount();
@@ -0,0 +1,43 @@
+#include <benchmark/benchmark.h>  // for State, Counter, BENCHMARK, DoNotOpti...
+
+#include <cstddef>  // for size_t
+#include <vector>   // for vector
+
+#include "advisor.hpp"    // for Advisor, Query
+#include "dices.hpp"      // for getUnorderedRollsProb
+#include "game.hpp"       // for Game
+#include "positions.hpp"  // for POSITIONS, BenchPosition
+
+// Every position with every roll, for both players
+static std::vector<Query> allQueries() {
+  std::vector<Query> queries;
+  for (const BenchPosition& position : POSITIONS) {
+    GameState state = Game(position.players).getState();
+    for (const auto& [roll, probability] : getUnorderedRollsProb()) {
+      queries.push_back({state, 1, roll});
+      queries.push_back({state, 2, roll});
+    }
+  }
+  return queries;
+}
+
+static void BM_AdvisorBatch(benchmark::State& state) {
+  const unsigned int nThreads = state.range(0);
+  const std::vector<Query> queries = allQueries();
+
+  for (auto _ : state) {
+    // A new advisor every time, so the cache starts empty
+    Advisor advisor(1, nThreads);
+    benchmark::DoNotOptimize(advisor.bestPlays(queries));
+  }
+
+  state.counters["queries"] = benchmark::Counter(
+      static_cast<double>(queries.size() * state.iterations()),
+      benchmark::Counter::kIsRate);
+}
+// One worker, and one worker per hardware thread
+BENCHMARK(BM_AdvisorBatch)
+    ->Arg(1)
+    ->Arg(0)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
@@ -0,0 +1,125 @@
+#include <benchmark/benchmark.h>  // for State, Counter, BENCHMARK, DoNotOpti...
+
+#include <cstddef>   // for size_t
+#include <optional>  // for optional
+
+#include "allocation_counter.hpp"  // for allocationCount
+#include "game.hpp"                // for Game, ScoredPlay, Game::MoveUndo
+#include "game_state.hpp"          // for GameState
+#include "positions.hpp"           // for POSITIONS, END_GAME, BenchPosition
+#include "search_budget.hpp"       // for SearchBudget
+#include "search_context.hpp"      // for SearchContext
+
+// Items per second and allocations per iteration
+static void setCounters(benchmark::State& state, const char* itemsName,
+                        std::size_t items, std::size_t allocations) {
+  state.counters[itemsName] = benchmark::Counter(static_cast<double>(items),
+                                                 benchmark::Counter::kIsRate);
+  state.counters["allocations"] = benchmark::Counter(
+      static_cast<double>(allocations), benchmark::Counter::kAvgIterations);
+}
+
+static void BM_AllPossibleStates(benchmark::State& state) {
+  const BenchPosition& position = POSITIONS[state.range(0)];
+  state.SetLabel(position.name);
+  const Game game(position.players);
+  const Player player = game.getPlayer(1);
+
+  std::size_t allocations = allocationCount();
+  std::size_t states = 0;
+  for (auto _ : state) {
+    auto turns = game.allPossibleStates(player, position.roll);
+    states += turns.size();
+    benchmark::DoNotOptimize(turns);
+  }
+
+  setCounters(state, "states", states, allocationCount() - allocations);
+}
+BENCHMARK(BM_AllPossibleStates)->DenseRange(0, POSITIONS.size() - 1);
+
+// How the turn generator gets the game after every candidate move: copying
+// the game and moving the piece on the copy (0), or making the move on the
+// game and unmaking it afterwards (1), as the search does with the turns.
+// The generator copies because unmaking the board costs more than copying
+// it.
+static void BM_ChildGame(benchmark::State& state) {
+  const BenchPosition& position = POSITIONS[state.range(0)];
+  const bool makeUnmake = state.range(1) == 1;
+  state.SetLabel(position.name);
+  Game game(position.players);
+  const GameState::Pieces pieces = game.getState().getPieces(1);
+
+  std::size_t allocations = allocationCount();
+  std::size_t children = 0;
+  for (auto _ : state) {
+    for (Position piece : pieces) {
+      for (unsigned int advance : {position.roll.first, position.roll.second}) {
+        if (makeUnmake) {
+          std::optional<Position> dest = game.destination(1, piece, advance);
+          if (!dest) continue;
+          Game::MoveUndo undo = game.makeMove({1, piece, *dest});
+          benchmark::DoNotOptimize(game);
+          game.unmakeMove(undo);
+        } else {
+          Game child = game;
+          if (!child.tryMovePiece(1, piece, advance)) continue;
+          benchmark::DoNotOptimize(child);
+        }
+        children++;
+      }
+    }
+  }
+
+  setCounters(state, "children", children, allocationCount() - allocations);
+}
+BENCHMARK(BM_ChildGame)
+    ->ArgsProduct({benchmark::CreateDenseRange(0, POSITIONS.size() - 1, 1),
+                   {0, 1}});
+
+static void BM_EvaluateState(benchmark::State& state) {
+  const unsigned int depth = state.range(0);
+  state.SetLabel(END_GAME.name);
+
+  Game game(END_GAME.players);
+  // The budget has no limits, it only counts the decision nodes
+  SearchBudget budget(SearchBudget::Clock::duration::zero());
+  SearchContext context;
+  context.budget = &budget;
+  game.setSearchContext(&context);
+
+  std::size_t allocations = allocationCount();
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(game.evaluateState(1, 2, depth, 1));
+  }
+
+  setCounters(state, "nodes", budget.spentNodes(),
+              allocationCount() - allocations);
+}
+BENCHMARK(BM_EvaluateState)->DenseRange(0, 3)->Unit(benchmark::kMillisecond);
+
+static void BM_BestPlay(benchmark::State& state) {
+  const BenchPosition& position = POSITIONS[state.range(0)];
+  const unsigned int depth = state.range(1);
+  state.SetLabel(position.name);
+
+  Game game(position.players);
+  // The budget has no limits, it only counts the decision nodes
+  SearchBudget budget(SearchBudget::Clock::duration::zero());
+  SearchContext context;
+  context.budget = &budget;
+  game.setSearchContext(&context);
+
+  std::size_t allocations = allocationCount();
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(game.bestPlay(1, position.roll, 1, depth));
+  }
+
+  setCounters(state, "nodes", budget.spentNodes(),
+              allocationCount() - allocations);
+}
+BENCHMARK(BM_BestPlay)
+    ->ArgsProduct({benchmark::CreateDenseRange(0, POSITIONS.size() - 1, 1),
+                   {0, 1}})
+    ->Unit(benchmark::kMillisecond);
+// The deepest search is only done on the position the tests use
+BENCHMARK(BM_BestPlay)->Args({1, 2})->Unit(benchmark::kMillisecond);
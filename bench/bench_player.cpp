@@ -0,0 +1,44 @@
+#include <benchmark/benchmark.h>  // for State, BENCHMARK, DoNotOptimize
+
+#include "allocation_counter.hpp"  // for allocationCount
+#include "board.hpp"               // for SquareMask
+#include "player.hpp"              // for Player
+
+static void BM_PlayerMovePiece(benchmark::State& state) {
+  const Player player{1, {HOME, 34, 62, firstHallway + 2}};
+  const SquareMask barriers{40};
+
+  std::size_t allocations = allocationCount();
+  for (auto _ : state) {
+    // Legal and illegal movements of every piece
+    for (unsigned int advance = 1; advance <= 6; advance++) {
+      for (Position piece : player.pieces) {
+        Player moved = player;
+        benchmark::DoNotOptimize(moved.tryMovePiece(piece, advance, barriers));
+      }
+    }
+  }
+
+  state.counters["allocations"] = benchmark::Counter(
+      allocationCount() - allocations, benchmark::Counter::kAvgIterations);
+}
+BENCHMARK(BM_PlayerMovePiece);
+
+// Same movements, but wrong ones throw
+static void BM_PlayerMovePieceThrowing(benchmark::State& state) {
+  const Player player{1, {HOME, 34, 62, firstHallway + 2}};
+  const SquareMask barriers{40};
+
+  for (auto _ : state) {
+    for (unsigned int advance = 1; advance <= 6; advance++) {
+      for (Position piece : player.pieces) {
+        Player moved = player;
+        try {
+          benchmark::DoNotOptimize(moved.movePiece(piece, advance, barriers));
+        } catch (const Player::WrongMove&) {
+        }
+      }
+    }
+  }
+}
+BENCHMARK(BM_PlayerMovePieceThrowing);
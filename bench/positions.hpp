@@ -0,0 +1,41 @@
+#pragma once
+
+#include <array>   // for array
+#include <string>  // for string
+
+#include "dices.hpp"  // for DicePairRoll
+#include "game.hpp"   // for Game, Game::Players
+#include "player.hpp"  // for Player
+#include "table.hpp"   // for GOAL, HOME
+
+// A position to benchmark and the roll of the player 1
+struct BenchPosition {
+  std::string name;
+  Game::Players players;
+  DicePairRoll roll;
+};
+
+static const std::array<BenchPosition, 5> POSITIONS{{
+    {"opening_double_five",
+     {Player({1, {HOME, HOME, HOME, HOME}}),
+      Player({2, {HOME, HOME, HOME, HOME}})},
+     {5, 5}},
+    {"middle_game",
+     {Player({1, {1, 34, 11, 7}}), Player({2, {GOAL - 3, 47, 35, 41}})},
+     {1, 2}},
+    {"barriers_double",
+     {Player({1, {7, 7, 20, HOME}}), Player({2, {12, 12, 40, HOME}})},
+     {3, 3}},
+    {"eat_boost",
+     {Player({1, {HOME, 10, 30, 50}}), Player({2, {14, 55, 36, HOME}})},
+     {4, 1}},
+    {"goal_boost",
+     {Player({1, {60, 104, 2, HOME}}), Player({2, {GOAL, 28, 103, 24}})},
+     {4, 6}},
+}};
+
+// Position with few movements, so it can be searched deeper
+static const BenchPosition END_GAME{
+    "end_game",
+    {Player({1, {GOAL, GOAL, 60, 104}}), Player({2, {GOAL, 28, 103, 24}})},
+    {5, 2}};
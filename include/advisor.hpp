@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstddef>  // for size_t
+#include <vector>   // for vector
+
+#include "dices.hpp"                // for DicePairRoll
+#include "game.hpp"                 // for Game, ScoredPlay
+#include "game_state.hpp"           // for GameState
+#include "table.hpp"                // for PlayerNumber
+#include "thread_pool.hpp"          // for ThreadPool
+#include "transposition_table.hpp"  // for TranspositionTable
+
+class EndgameTable;
+class OpeningBook;
+
+// Position and roll of a player asking for the best play
+struct Query {
+  GameState state;
+  PlayerNumber player;
+  DicePairRoll roll;
+  unsigned int rollsInARow{1};
+};
+
+// Answers many queries at once.
+// The workers and the cache are kept between calls, so the queries of all
+// the calls share what has already been searched.
+class Advisor {
+ public:
+  explicit Advisor(
+      unsigned int depth = 2, unsigned int nThreads = 0,
+      std::size_t cacheCapacity = TranspositionTable::DEFAULT_CAPACITY);
+
+  Advisor(const Advisor&) = delete;
+  Advisor& operator=(const Advisor&) = delete;
+
+  // Best play for every query, in the same order
+  std::vector<ScoredPlay> bestPlays(const std::vector<Query>& queries);
+  ScoredPlay bestPlay(const Query& query);
+
+  // Scores the solved endgames with the table, nullptr to stop using it.
+  // The table is not owned and the cache is cleared, as it has the old scores.
+  void setEndgameTable(const EndgameTable* table);
+  // Answers the queries in the book without searching them, nullptr to stop
+  // using it. The book is not owned.
+  void setOpeningBook(const OpeningBook* book) { openingBook = book; }
+
+  unsigned int getDepth() const { return depth; }
+  const TranspositionTable& getTranspositionTable() const {
+    return transpositionTable;
+  }
+
+ private:
+  unsigned int depth;
+  ThreadPool threadPool;
+  TranspositionTable transpositionTable;
+  const EndgameTable* endgameTable{nullptr};
+  const OpeningBook* openingBook{nullptr};
+};
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <cstddef>          // for size_t, byte
+#include <memory>           // for unique_ptr
+#include <memory_resource>  // for memory_resource
+#include <vector>           // for vector
+
+// Memory for the containers that only live while a node is searched.
+// Allocating moves a pointer forward and deallocating does nothing. All the
+// memory allocated inside a Scope is given back at once when the scope ends,
+// so every node reuses the memory of its previous siblings.
+// The blocks are kept when the memory is given back, so once the arena has
+// grown enough for a search it does not allocate anymore.
+// It is not thread safe: every thread uses its own arena.
+class Arena : public std::pmr::memory_resource {
+ public:
+  explicit Arena(std::size_t blockSize = DEFAULT_BLOCK_SIZE);
+
+  Arena(const Arena&) = delete;
+  Arena& operator=(const Arena&) = delete;
+
+  // Arena of the calling thread
+  static Arena& local();
+
+  struct Stats {
+    // Requests served by the arena
+    std::size_t allocations{0};
+    std::size_t bytes{0};
+    // Blocks requested to the system
+    std::size_t blocks{0};
+  };
+
+  // Gives back everything allocated while it lives.
+  // The scopes of an arena must end in the opposite order they started.
+  class Scope {
+   public:
+    explicit Scope(Arena& arena);
+    ~Scope();
+
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+    // No other scope of the arena started before this one is still alive
+    bool isOutermost() const { return outermost; }
+    // Work done by the arena since the scope started
+    Stats stats() const;
+
+   private:
+    Arena& arena;
+    bool outermost;
+    std::size_t block;
+    std::size_t offset;
+    Stats start;
+  };
+
+  // Work done by the arena since it was created
+  const Stats& stats() const { return counters; }
+  // Bytes allocated and not given back yet
+  std::size_t used() const;
+  // Bytes of all the blocks
+  std::size_t capacity() const;
+
+  static constexpr std::size_t DEFAULT_BLOCK_SIZE = 64 * 1024;
+
+ private:
+  void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+  void do_deallocate(void*, std::size_t, std::size_t) override {}
+  bool do_is_equal(
+      const std::pmr::memory_resource& other) const noexcept override {
+    return this == &other;
+  }
+
+  struct Block {
+    std::unique_ptr<std::byte[]> memory;
+    std::size_t size;
+  };
+
+  std::vector<Block> blocks;
+  // The next allocation starts at this offset of this block. The blocks
+  // after it are free.
+  std::size_t topBlock{0};
+  std::size_t topOffset{0};
+  std::size_t blockSize;
+
+  unsigned int openScopes{0};
+  Stats counters;
+};
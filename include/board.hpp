@@ -0,0 +1,217 @@
+#pragma once
+
+#include <array>             // for array
+#include <bit>               // for popcount
+#include <cstdint>           // for uint64_t, uint8_t
+#include <initializer_list>  // for initializer_list
+
+#include "game_state.hpp"  // for N_PLAYERS
+#include "table.hpp"       // for Position, PlayerNumber, HOME, isCommonPo...
+
+// Set of common positions stored as one bit per position
+class SquareMask {
+ public:
+  constexpr SquareMask() = default;
+  constexpr SquareMask(std::initializer_list<Position> positions) {
+    for (Position position : positions) set(position);
+  }
+
+  // All the positions in [first, last]
+  static constexpr SquareMask range(Position first, Position last) {
+    SquareMask mask;
+    if (first < 1) first = 1;
+    if (last > totalPositions) last = totalPositions;
+    if (first > last) return mask;
+
+    mask.low = bitsBetween(first - 1, last - 1);
+    if (last > LOW_BITS) {
+      unsigned int highFirst = (first > LOW_BITS) ? first - 1 - LOW_BITS : 0;
+      mask.high = bitsBetween(highFirst, last - 1 - LOW_BITS);
+    }
+
+    return mask;
+  }
+
+  // Only common positions can be stored, the rest are ignored
+  constexpr void set(Position position) {
+    if (!isCommonPosition(position)) return;
+    word(position) |= bit(position);
+  }
+  constexpr void reset(Position position) {
+    if (!isCommonPosition(position)) return;
+    word(position) &= ~bit(position);
+  }
+  constexpr bool test(Position position) const {
+    if (!isCommonPosition(position)) return false;
+    return (word(position) & bit(position)) != 0;
+  }
+
+  constexpr bool any() const { return (low | high) != 0; }
+  constexpr bool none() const { return !any(); }
+  constexpr unsigned int count() const {
+    return std::popcount(low) + std::popcount(high);
+  }
+
+  constexpr SquareMask operator&(const SquareMask& other) const {
+    return SquareMask(low & other.low, high & other.high);
+  }
+  constexpr SquareMask operator|(const SquareMask& other) const {
+    return SquareMask(low | other.low, high | other.high);
+  }
+  constexpr SquareMask& operator&=(const SquareMask& other) {
+    return *this = *this & other;
+  }
+  constexpr SquareMask& operator|=(const SquareMask& other) {
+    return *this = *this | other;
+  }
+
+  constexpr bool operator==(const SquareMask&) const = default;
+
+ private:
+  // Number of positions stored in the first word
+  static constexpr unsigned int LOW_BITS = 64;
+  static_assert(totalPositions <= 2 * LOW_BITS);
+
+  constexpr SquareMask(std::uint64_t low, std::uint64_t high)
+      : low(low), high(high) {}
+
+  // Bits from first to last, both included
+  static constexpr std::uint64_t bitsBetween(unsigned int first,
+                                             unsigned int last) {
+    if (first > last || first >= LOW_BITS) return 0;
+    if (last >= LOW_BITS) last = LOW_BITS - 1;
+    std::uint64_t upToLast =
+        (last == LOW_BITS - 1) ? ~std::uint64_t{0}
+                               : (std::uint64_t{1} << (last + 1)) - 1;
+    return upToLast & ~((std::uint64_t{1} << first) - 1);
+  }
+
+  static constexpr std::uint64_t bit(Position position) {
+    return std::uint64_t{1} << ((position - 1) % LOW_BITS);
+  }
+  constexpr std::uint64_t& word(Position position) {
+    return (position > LOW_BITS) ? high : low;
+  }
+  constexpr const std::uint64_t& word(Position position) const {
+    return (position > LOW_BITS) ? high : low;
+  }
+
+  // Positions from 1 to 64
+  std::uint64_t low{0};
+  // Positions from 65 to totalPositions
+  std::uint64_t high{0};
+};
+
+// Number of pieces on each common position of the table, up to three
+class SquareCounter {
+ public:
+  // Places a piece on the position
+  constexpr void add(Position position) {
+    SquareMask square{position};
+    atLeastThree |= atLeastTwo & square;
+    atLeastTwo |= atLeastOne & square;
+    atLeastOne |= square;
+  }
+
+  // Removes a piece from the position
+  constexpr void remove(Position position) {
+    if (atLeastThree.test(position)) {
+      atLeastThree.reset(position);
+    } else if (atLeastTwo.test(position)) {
+      atLeastTwo.reset(position);
+    } else {
+      atLeastOne.reset(position);
+    }
+  }
+
+  constexpr unsigned int count(Position position) const {
+    return atLeastOne.test(position) + atLeastTwo.test(position) +
+           atLeastThree.test(position);
+  }
+
+  // Pieces on both counters, saturated to three
+  constexpr SquareCounter operator+(const SquareCounter& other) const {
+    SquareCounter sum;
+    sum.atLeastOne = atLeastOne | other.atLeastOne;
+    sum.atLeastTwo = atLeastTwo | other.atLeastTwo |
+                     (atLeastOne & other.atLeastOne);
+    sum.atLeastThree = atLeastThree | other.atLeastThree |
+                       (atLeastTwo & other.atLeastOne) |
+                       (atLeastOne & other.atLeastTwo);
+    return sum;
+  }
+
+  constexpr bool operator==(const SquareCounter&) const = default;
+
+  SquareMask atLeastOne;
+  SquareMask atLeastTwo;
+  // Only possible when a piece gets out of home to a barrier
+  SquareMask atLeastThree;
+};
+
+// Pieces of every player on each common position of the table and at home.
+// There are no barriers nor rival pieces in the hallways, so they are not
+// stored.
+class Board {
+ public:
+  // Places a piece of the player on the position
+  constexpr void add(PlayerNumber player, Position position) {
+    if (position == HOME) {
+      atHome[player - 1]++;
+    } else {
+      squares[player - 1].add(position);
+    }
+  }
+
+  // Removes a piece of the player from the position
+  constexpr void remove(PlayerNumber player, Position position) {
+    if (position == HOME) {
+      atHome[player - 1]--;
+    } else {
+      squares[player - 1].remove(position);
+    }
+  }
+
+  // Moves a piece of the player from one position to the other
+  constexpr void move(PlayerNumber player, Position origin, Position dest) {
+    remove(player, origin);
+    add(player, dest);
+  }
+
+  // Pieces of all the players on a common position
+  constexpr unsigned int count(Position position) const {
+    unsigned int pieces{0};
+    for (const SquareCounter& playerSquares : squares) {
+      pieces += playerSquares.count(position);
+    }
+    return pieces;
+  }
+  // Pieces of the player on a common position or at home
+  constexpr unsigned int count(PlayerNumber player, Position position) const {
+    if (position == HOME) return atHome[player - 1];
+    return squares[player - 1].count(position);
+  }
+
+  // Positions with at least one piece of the player
+  constexpr const SquareMask& occupied(PlayerNumber player) const {
+    return squares[player - 1].atLeastOne;
+  }
+  // Positions with at least one piece
+  constexpr SquareMask occupied() const { return total().atLeastOne; }
+  // Positions with two or more pieces, of any player
+  constexpr SquareMask barriers() const { return total().atLeastTwo; }
+
+  constexpr bool operator==(const Board&) const = default;
+
+ private:
+  constexpr SquareCounter total() const {
+    SquareCounter sum;
+    for (const SquareCounter& playerSquares : squares) {
+      sum = sum + playerSquares;
+    }
+    return sum;
+  }
+
+  std::array<SquareCounter, N_PLAYERS> squares{};
+  std::array<std::uint8_t, N_PLAYERS> atHome{};
+};
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <condition_variable>  // for condition_variable
+#include <cstddef>             // for size_t
+#include <deque>               // for deque
+#include <mutex>               // for mutex, unique_lock, lock_guard
+#include <optional>            // for optional, nullopt
+#include <utility>             // for move
+
+// Queue between a producer and a consumer thread.
+// The producer waits while it is full, so the memory used is bounded.
+template <typename T>
+class BoundedQueue {
+ public:
+  explicit BoundedQueue(std::size_t capacity) : capacity(capacity) {}
+
+  // Waits until there is room for the item
+  void push(T item) {
+    std::unique_lock lock(mutex);
+    notFull.wait(lock, [this] { return items.size() < capacity; });
+    items.push_back(std::move(item));
+    notEmpty.notify_one();
+  }
+
+  // No more items will be pushed
+  void close() {
+    std::lock_guard lock(mutex);
+    closed = true;
+    notEmpty.notify_all();
+  }
+
+  // Waits for an item. Returns nothing once the queue is closed and empty.
+  std::optional<T> pop() {
+    std::unique_lock lock(mutex);
+    notEmpty.wait(lock, [this] { return closed || !items.empty(); });
+    return takeFront();
+  }
+
+  // Returns nothing if there is no item right now
+  std::optional<T> tryPop() {
+    std::lock_guard lock(mutex);
+    return takeFront();
+  }
+
+ private:
+  std::optional<T> takeFront() {
+    if (items.empty()) return std::nullopt;
+    T item = std::move(items.front());
+    items.pop_front();
+    notFull.notify_one();
+    return item;
+  }
+
+  std::size_t capacity;
+  std::deque<T> items;
+  bool closed{false};
+
+  std::mutex mutex;
+  std::condition_variable notFull;
+  std::condition_variable notEmpty;
+};
@@ -137,3 +137,9 @@ static constexpr UnorderedRollsProb getUnorderedRollsProb() {
 
 // Number needed to get of from home
 static constexpr DiceRoll OUT_OF_HOME = 5;
+
+// Positions a piece moves after another one gets to the goal
+static constexpr unsigned int EXTRA_MOVEMENT_ON_GOAL = 10;
+
+// Positions a piece moves after eating a piece of other player
+static constexpr unsigned int EXTRA_MOVEMENT_ON_KILL = 20;
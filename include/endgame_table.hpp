@@ -0,0 +1,113 @@
+#pragma once
+
+#include <array>      // for array
+#include <cstddef>    // for size_t
+#include <optional>   // for optional
+#include <stdexcept>  // for invalid_argument
+#include <string>     // for string
+#include <vector>     // for vector
+
+#include "game_state.hpp"   // for GameState, N_PIECES
+#include "mapped_file.hpp"  // for MappedFile
+#include "table.hpp"        // for hallwayLength
+
+// Exact punctuation of the endgames where all the pieces of a player are in
+// its hallway or on the goal.
+// There the player can neither eat nor be eaten, nor make barriers that stop
+// the other one, so its race does not depend on the other player and it can be
+// solved backwards from the goal. The punctuation is the expected number of
+// rolls it needs to finish playing the best turns, in the units of
+// Player::piecesPunctuation.
+// The table also keeps the chances of finishing within every number of turns,
+// so when both players are in the table the race is decided by who rolls
+// first, see winProbability.
+// The table is solved offline and mapped from a file, see
+// tools/generate_endgame_table.cpp.
+class EndgameTable {
+ public:
+  // Turns the chances of finishing are kept for. The chances of needing more
+  // are below 1e-9 for every position.
+  static constexpr unsigned int MAX_TURNS = 100;
+  // Rolls a player can make in the same turn
+  static constexpr unsigned int MAX_ROLLS_IN_A_ROW = 3;
+
+  struct Entry {
+    // Punctuation of the position before rolling the dices for the first time
+    // in the turn
+    double punctuation;
+    // Highest punctuation of the positions the player can get to from this
+    // one. It is what keeps the pruning of the search valid.
+    double maxReachablePunctuation;
+  };
+
+  // Every piece is from 0 to hallwayLength positions away from the goal
+  static constexpr std::size_t N_DISTANCES = hallwayLength + 1;
+  // Number of positions with the pieces sorted
+  static constexpr std::size_t N_POSITIONS = [] {
+    std::size_t positions = 1;
+    for (std::size_t i = 0; i < N_PIECES; i++) {
+      positions = positions * (N_DISTANCES + i) / (i + 1);
+    }
+    return positions;
+  }();
+
+  // Solves all the positions
+  static EndgameTable solve();
+
+  // Maps a table written by save, so loading it does not read the positions
+  static EndgameTable load(const std::string& path);
+  void save(const std::string& path) const;
+
+  // The positions are kept where the table was solved or loaded
+  EndgameTable(EndgameTable&&) = default;
+  EndgameTable& operator=(EndgameTable&&) = default;
+  EndgameTable(const EndgameTable&) = delete;
+  EndgameTable& operator=(const EndgameTable&) = delete;
+
+  // Whether the pieces are in the table. A player that has already won is
+  // not, so the search keeps scoring it as a win.
+  static bool covers(const GameState::Pieces&);
+  // The pieces must be covered
+  const Entry& at(const GameState::Pieces&) const;
+
+  // Highest punctuation of the table
+  double maxPunctuation() const { return highestPunctuation; }
+
+  // Chances of the player that is about to roll for the time rollsInARow in
+  // its turn of getting all its pieces to the goal before the other player,
+  // who rolls after the turn ends. Both players play the turns that finish in
+  // the fewest rolls. The pieces of both must be covered.
+  double winProbability(const GameState::Pieces& rolling,
+                        unsigned int rollsInARow,
+                        const GameState::Pieces& other) const;
+
+  struct InvalidFile : public std::invalid_argument {
+    using std::invalid_argument::invalid_argument;
+  };
+
+ private:
+  EndgameTable() = default;
+
+  // Indexed by the distances to goal of the sorted pieces, written as a
+  // number in base N_DISTANCES
+  static constexpr std::size_t N_INDICES = [] {
+    std::size_t indices = 1;
+    for (std::size_t i = 0; i < N_PIECES; i++) indices *= N_DISTANCES;
+    return indices;
+  }();
+
+  // Chances of getting all the pieces to the goal within the number of turns,
+  // counting the current one, for the rolls already made in the turn
+  using FinishedWithin =
+      std::array<std::array<double, MAX_TURNS + 1>, MAX_ROLLS_IN_A_ROW>;
+
+  // A loaded table is used right from its file, a solved one from memory.
+  // Both only have the sorted positions, in the order they are saved.
+  std::optional<MappedFile> file;
+  std::vector<Entry> solvedEntries;
+  std::vector<FinishedWithin> solvedFinishedWithin;
+
+  const Entry* entries{nullptr};
+  const FinishedWithin* finishedWithin{nullptr};
+  double highestPunctuation{0.0};
+};
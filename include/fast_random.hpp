@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstdint>  // for uint64_t
+
+#include "dices.hpp"  // for DicePairRoll, DiceRoll, DICE_FACES
+
+// Small and fast generator of random numbers (SplitMix64).
+// The same seed always gives the same sequence.
+class FastRandom {
+ public:
+  explicit constexpr FastRandom(std::uint64_t seed) : state(seed) {}
+
+  constexpr std::uint64_t next() {
+    std::uint64_t z = (state += 0x9E3779B97F4A7C15);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EB;
+    return z ^ (z >> 31);
+  }
+
+  // Number in [0, n). The bias is negligible for small n.
+  constexpr std::uint64_t below(std::uint64_t n) { return next() % n; }
+
+  DicePairRoll rollDices() {
+    DiceRoll first = static_cast<DiceRoll>(below(DICE_FACES)) + 1;
+    DiceRoll second = static_cast<DiceRoll>(below(DICE_FACES)) + 1;
+    return {first, second};
+  }
+
+ private:
+  std::uint64_t state;
+};
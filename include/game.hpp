@@ -1,24 +1,55 @@
 #pragma once
 
 #include <array>      // for array
-#include <set>        // for set
+#include <cmath>      // for INFINITY
+#include <cstddef>    // for size_t
+#include <cstdint>    // for uint8_t, uint64_t
+#include <optional>   // for optional
 #include <stdexcept>  // for invalid_argument
 #include <string>     // for string
 #include <vector>     // for vector
 
-#include "dices.hpp"   // for DicePairRoll, DiceRoll
-#include "player.hpp"  // for Player
-#include "table.hpp"   // for Position, PlayerNumber
+#include "board.hpp"          // for Board
+#include "dices.hpp"          // for DicePairRoll, DiceRoll
+#include "game_state.hpp"     // for GameState, N_PLAYERS, N_PIECES
+#include "player.hpp"         // for Player
+#include "static_vector.hpp"  // for StaticVector
+#include "table.hpp"          // for Position, PlayerNumber, GOAL
 
-// Each time a player moves a piece
+// Each time a player moves a piece.
+// Every position fits in a byte, so a move takes three bytes.
 struct Move {
-  PlayerNumber player;
-  Position origin;
-  Position dest;
+  constexpr Move() = default;
+  constexpr Move(PlayerNumber player, Position origin, Position dest)
+      : player(static_cast<std::uint8_t>(player)),
+        origin(static_cast<std::uint8_t>(origin)),
+        dest(static_cast<std::uint8_t>(dest)) {}
+
+  std::uint8_t player{0};
+  std::uint8_t origin{0};
+  std::uint8_t dest{0};
 };
+static_assert(GOAL <= UINT8_MAX && N_PLAYERS <= UINT8_MAX);
+
+// Most advances a turn can have: the two dices and a boost for every piece
+// that gets to the goal or eats a rival piece
+static constexpr std::size_t MAX_TURN_ADVANCES =
+    2 + N_PIECES + N_PIECES * (N_PLAYERS - 1);
+// Every advance moves a piece and may take an eaten piece home
+static constexpr std::size_t MAX_TURN_MOVES = 2 * MAX_TURN_ADVANCES;
 
 // All the movements that occur during a player's turn
-using Play = std::vector<Move>;
+using Play = StaticVector<Move, MAX_TURN_MOVES>;
+
+// The same play on the mirrored state, see mirrorState
+inline Play mirrorPlay(const Play& play) {
+  Play mirrored;
+  for (const Move& move : play) {
+    mirrored.push_back({mirrorPlayer(move.player), mirrorPosition(move.origin),
+                        mirrorPosition(move.dest)});
+  }
+  return mirrored;
+}
 
 // The score of the table after executing the play
 struct ScoredPlay {
@@ -26,20 +57,39 @@ struct ScoredPlay {
   double score;
 };
 
-using MovementsSequence = std::vector<unsigned int>;
+// Range of scores the caller of a search is interested in.
+// Scores out of (alpha, beta) are only bounds: a search that gets a score
+// lower or equal than alpha only knows its real score is not higher, and the
+// same for the scores higher or equal than beta.
+struct SearchWindow {
+  double alpha{-INFINITY};
+  double beta{INFINITY};
+
+  // The same window seen by the other player
+  SearchWindow flipped() const { return {-beta, -alpha}; }
+};
+
+// Best play found by a search that has to stop on time
+struct AnytimePlay {
+  ScoredPlay scoredPlay;
+  // Depth of the deepest search that was completed
+  unsigned int depth{0};
+};
+
+using MovementsSequence = StaticVector<unsigned int, MAX_TURN_ADVANCES>;
+
+class SearchBudget;
+struct SearchContext;
 
 class Game {
  public:
-  using Players = std::array<Player, 2>;
-  using LastTouched = std::array<Position, 2>;
+  using Players = std::array<Player, N_PLAYERS>;
 
   // The movements a player does to get to a particular table state
   struct Turn {
-    struct FinalState {
-      // Final state of the game
-      Players players;
-      LastTouched lastTouched;
-    } finalState;
+    // Final state of the game
+    using FinalState = GameState;
+    FinalState finalState;
 
     // Movements to get that state
     Play movements;
@@ -51,76 +101,119 @@ class Game {
 
   std::vector<Turn> allPossibleStates(const Player&, const DicePairRoll&,
                                       unsigned int rollsInARow = 1) const;
+  // Same as allPossibleStates, but writes the turns into the buffer and
+  // reuses the memory it already has.
+  // The buffer is a std::vector or a std::pmr::vector of turns.
+  template <typename Turns>
+  void generateTurns(PlayerNumber, const DicePairRoll&,
+                     unsigned int rollsInARow, Turns& turns) const;
   std::vector<Turn> tripleDouble(PlayerNumber) const;
 
   std::vector<Turn> allPossibleStatesFromSequence(
-      const Player& currentPlayer, const MovementsSequence& advances) const;
+      PlayerNumber currentPlayer, const MovementsSequence& advances) const;
 
+  // The best play is exact when its score is inside the window.
+  // A search of the depth of the opening book of the context is served from
+  // the book when it has the decision.
   ScoredPlay bestPlay(PlayerNumber, DicePairRoll, unsigned int rollsInARow = 1,
-                      unsigned int depth = 2) const;
+                      unsigned int depth = 2,
+                      const SearchWindow& window = {}) const;
+
+  // Searches deeper and deeper until the budget is spent and returns the best
+  // play of the deepest search completed. The search of depth 0 is always
+  // completed, so there is always a play.
+  AnytimePlay bestPlayInBudget(PlayerNumber, DicePairRoll, SearchBudget& budget,
+                               unsigned int rollsInARow = 1) const;
 
-  // Returns a pointer to the player who owns the piece
-  // I would eat on the given position
-  Player* eatenPlayer(const Player& eater, Position destPosition);
+  // Returns the player who owns the piece I would eat on the given position.
+  // Returns 0 if no piece would be eaten.
+  PlayerNumber eatenPlayer(PlayerNumber eater, Position destPosition) const;
 
-  // Move the piece and update the barrier set
+  // Move the piece and update the board
   Position movePiece(PlayerNumber playerNumber, Position piece,
                      unsigned int advance);
-  Position movePiece(Player& player, Position piece, unsigned int advance);
+  // Same as movePiece, but returns nothing instead of throwing if the piece
+  // cannot be moved
+  std::optional<Position> tryMovePiece(PlayerNumber playerNumber,
+                                       Position piece, unsigned int advance);
 
-  // Take piece to position and update the barrier set
+  // Take piece to position and update the board
   void takePiece(PlayerNumber playerNumber, Position piece, Position dest);
-  void takePiece(Player& player, Position piece, Position dest);
 
-  // Move the piece to home and update the barrier set
+  // What a move changed, so it can be reverted exactly
+  struct MoveUndo {
+    Move move;
+    // Index of the moved piece among the pieces of the player
+    std::uint8_t pieceIndex;
+    Position lastTouched;
+    double punctuation;
+    std::uint64_t hash;
+  };
+  // Same as takePiece, but returns what it needs to be reverted
+  MoveUndo makeMove(const Move& move);
+  // Reverts the last move made that has not been reverted yet
+  void unmakeMove(const MoveUndo& undo);
+
+  // Position the piece would get to, or nothing if it cannot be moved
+  std::optional<Position> destination(PlayerNumber playerNumber, Position piece,
+                                      unsigned int advance) const;
+
+  // Move the piece to home and update the board
   void pieceEaten(PlayerNumber playerNumber, Position eatenPiece);
-  void pieceEaten(Player& player, Position eatenPiece);
 
-  const Player& getPlayer(PlayerNumber) const;
-  Player& getPlayer(PlayerNumber);
-  const Player& getNextPlayer(PlayerNumber) const;
-  Player& getNextPlayer(PlayerNumber);
+  // Copies of the players built from the state of the game
+  Player getPlayer(PlayerNumber) const;
+  Player getNextPlayer(PlayerNumber) const;
+  Players getPlayers() const;
 
   Position getLastTouched(PlayerNumber) const;
   void setLastTouched(PlayerNumber, Position);
-  void setLastTouched(const Player&, Position);
-
-  void updateInnerState(const Player&, Position);
 
-  double evaluateState(const Player& currPlayer, const Player& nextPlayer,
-                       unsigned int depth, unsigned int rollsInARow) const;
-  double nonRecursiveEvaluateState(const Player&) const;
+  double evaluateState(PlayerNumber currentPlayer, PlayerNumber nextPlayer,
+                       unsigned int depth, unsigned int rollsInARow,
+                       const SearchWindow& window = {}) const;
+  double nonRecursiveEvaluateState(PlayerNumber) const;
+  // Punctuation of the player, kept up to date on every movement
+  double getPunctuation(PlayerNumber player) const {
+    return punctuations[player - 1];
+  }
 
   Game stateAfterMovement(const Player& player, Position ori,
                           unsigned int positionsToMove) const;
 
-  Turn::FinalState getState() const { return {players, lastTouched}; };
+  const Turn::FinalState& getState() const { return state; };
+  // Hash of the state, kept up to date on every movement.
+  // It does not depend on the order of the pieces.
+  std::uint64_t getHash() const { return hash; }
+
+  // Resources used to search from this state. It is shared with all the
+  // states derived from this one during the search. Pass nullptr to search
+  // without cache on a single thread.
+  void setSearchContext(const SearchContext* context) {
+    searchContext = context;
+  }
+  const SearchContext* getSearchContext() const { return searchContext; }
 
   struct ImpossibleMovement : public std::invalid_argument {
     using std::invalid_argument::invalid_argument;
   };
 
- private:
-  LastTouched initLastTouched() const {
-    LastTouched values{};
-
-    constexpr auto nPlayers{std::tuple_size<decltype(players)>()};
-    static_assert(nPlayers == std::tuple_size<decltype(values)>());
-
-    for (unsigned int i = 0; i < nPlayers; i++) {
-      const Player& player = players[i];
-
-      // If no other information is given,
-      // I pick the last touched piece is the first one
-      values[i] = player.pieces.front();
-    }
-
-    return values;
-  }
-
  public:
-  Players players;
-  std::set<Position> barriers;
-  // Each player has an iterator of the container of their pieces
-  LastTouched lastTouched{initLastTouched()};
+  // Pieces of every player and the last piece they touched
+  GameState state;
+  // Pieces on every position, kept up to date on every movement
+  Board board;
+
+ private:
+  // Same as bestPlay, without the opening book. The inner nodes of the search
+  // are searched with it.
+  ScoredPlay searchBestPlay(PlayerNumber, DicePairRoll,
+                            unsigned int rollsInARow, unsigned int depth,
+                            const SearchWindow& window) const;
+
+  // Punctuation of every player, so the leaves do not go through the pieces
+  std::array<double, N_PLAYERS> punctuations{};
+  std::uint64_t hash{0};
+  // Not owned by the game
+  const SearchContext* searchContext{nullptr};
 };
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <array>        // for array
+#include <cstdint>      // for uint8_t, uint64_t
+#include <utility>      // for swap
+#include <type_traits>  // for is_trivially_copyable_v
+
+#include "table.hpp"  // for GOAL, HOME, Position, PlayerNumber
+
+// Number of players in the game
+static constexpr unsigned int N_PLAYERS = 2;
+
+// Number of pieces of every player
+static constexpr unsigned int N_PIECES = 4;
+
+// Compact state of the table: the pieces of every player and the last piece
+// each of them touched.
+// This is what the search copies and stores, so it must stay small and
+// trivially copyable. Barriers are derived from it.
+struct GameState {
+  // Every position fits in a byte: from HOME to GOAL
+  using Square = std::uint8_t;
+  using Pieces = std::array<Square, N_PIECES>;
+
+  // Pieces of the player number i + 1
+  std::array<Pieces, N_PLAYERS> pieces{};
+  // Position of the last piece touched by the player number i + 1
+  std::array<Square, N_PLAYERS> lastTouched{};
+
+  constexpr const Pieces& getPieces(PlayerNumber player) const {
+    return pieces[player - 1];
+  }
+  constexpr Pieces& getPieces(PlayerNumber player) {
+    return pieces[player - 1];
+  }
+
+  constexpr bool operator==(const GameState&) const = default;
+};
+
+// Player who takes the place of the given one when the board is rotated
+static constexpr PlayerNumber mirrorPlayer(PlayerNumber player) {
+  return N_PLAYERS + 1 - player;
+}
+
+// The same state with the board rotated, see mirrorPosition: every player
+// gets the pieces of the other one. Both states are equally good for the
+// players that take each other's place, so they have the same scores.
+static constexpr GameState mirrorState(const GameState& state) {
+  static_assert(N_PLAYERS == 2, "The board only has two sides");
+  GameState mirrored;
+  for (PlayerNumber player = 1; player <= N_PLAYERS; player++) {
+    const PlayerNumber other = mirrorPlayer(player);
+    const GameState::Pieces& pieces = state.getPieces(player);
+    for (unsigned int i = 0; i < N_PIECES; i++) {
+      mirrored.getPieces(other)[i] =
+          static_cast<GameState::Square>(mirrorPosition(pieces[i]));
+    }
+    mirrored.lastTouched[other - 1] = static_cast<GameState::Square>(
+        mirrorPosition(state.lastTouched[player - 1]));
+  }
+  return mirrored;
+}
+
+static_assert(GOAL <= UINT8_MAX);
+static_assert(std::is_trivially_copyable_v<GameState>);
+static_assert(sizeof(GameState) == N_PLAYERS * (N_PIECES + 1));
+
+// Bits of a position in a canonical key
+static constexpr unsigned int CANONICAL_POSITION_BITS = 7;
+// Bits of the index of the last touched piece in a canonical key
+static constexpr unsigned int CANONICAL_INDEX_BITS = 3;
+
+static_assert(GOAL < (1 << CANONICAL_POSITION_BITS));
+static_assert(N_PLAYERS * (N_PIECES * CANONICAL_POSITION_BITS +
+                           CANONICAL_INDEX_BITS) <=
+              64);
+
+// Packs the state ignoring the order of the pieces: the sorted pieces of
+// every player and the index of its last touched piece among them.
+// Two states have the same key if they have the same pieces and the same last
+// touched pieces. A last touched position that is not one of the pieces is not
+// kept, but Game only sets the ones of the pieces it moves, so the turns
+// generated from the same state never differ only on it.
+static constexpr std::uint64_t canonicalKey(const GameState& state) {
+  std::uint64_t key{0};
+  for (unsigned int i = 0; i < N_PLAYERS; i++) {
+    // Sorting network for the four pieces
+    GameState::Pieces pieces = state.pieces[i];
+    auto sortPair = [&pieces](unsigned int first, unsigned int second) {
+      if (pieces[second] < pieces[first]) {
+        std::swap(pieces[first], pieces[second]);
+      }
+    };
+    static_assert(N_PIECES == 4);
+    sortPair(0, 1);
+    sortPair(2, 3);
+    sortPair(0, 2);
+    sortPair(1, 3);
+    sortPair(1, 2);
+
+    unsigned int lastTouchedIndex = N_PIECES;
+    for (unsigned int j = 0; j < N_PIECES; j++) {
+      key = (key << CANONICAL_POSITION_BITS) | pieces[j];
+      if (pieces[j] == state.lastTouched[i] && lastTouchedIndex == N_PIECES) {
+        lastTouchedIndex = j;
+      }
+    }
+    key = (key << CANONICAL_INDEX_BITS) | lastTouchedIndex;
+  }
+
+  return key;
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstddef>   // for size_t
+#include <optional>  // for optional
+#include <string>    // for string
+#include <vector>    // for vector
+
+// Read only contents of a file, mapped into memory as they are where the
+// system can map files, so nothing is read until it is used. Elsewhere the
+// file is copied into memory.
+class MappedFile {
+ public:
+  // Nothing if the file cannot be opened
+  static std::optional<MappedFile> open(const std::string& path);
+
+  MappedFile(MappedFile&& other) noexcept;
+  MappedFile& operator=(MappedFile&& other) noexcept;
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+  ~MappedFile();
+
+  const char* data() const { return begin; }
+  std::size_t size() const { return length; }
+
+ private:
+  MappedFile() = default;
+
+  // Mapped file, nullptr where files cannot be mapped or it is empty
+  void* mapping{nullptr};
+  // Copy of the file where it cannot be mapped
+  std::vector<char> buffer;
+
+  const char* begin{nullptr};
+  std::size_t length{0};
+};
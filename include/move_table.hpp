@@ -0,0 +1,132 @@
+#pragma once
+
+#include <array>    // for array
+#include <cstdint>  // for uint8_t, UINT8_MAX
+
+#include "dices.hpp"       // for OUT_OF_HOME, EXTRA_MOVEMENT_ON_GOAL, EXTRA_...
+#include "game_state.hpp"  // for N_PLAYERS
+#include "table.hpp"       // for Position, PlayerNumber, GOAL, HOME, getPla...
+
+// Returned when a piece cannot advance the asked positions
+static constexpr Position NO_DESTINATION = UINT8_MAX;
+
+// Position a piece gets to after advancing, without taking into account
+// the barriers or the rest of the pieces
+static constexpr Position computeDestination(PlayerNumber player,
+                                             Position piece,
+                                             unsigned int advance) {
+  // If the piece is at home the only move it can make is exit
+  if (piece == HOME) {
+    if (advance != OUT_OF_HOME) return NO_DESTINATION;
+    return getPlayerInitialPosition(player);
+  }
+
+  // The piece is in a common position
+  if (isCommonPosition(piece)) {
+    unsigned int distanceToHallWay =
+        1 + distanceToPosition(piece, getPlayerLastPosition(player));
+
+    // If the piece advance all the positions the dice say it does not get into
+    // the hallway
+    if (distanceToHallWay > advance) return correctPosition(piece + advance);
+
+    // The piece will get to the hallway. Let's check it can move that far
+    unsigned int distanceToGoal = distanceToHallWay + hallwayLength;
+    if (distanceToGoal < advance) return NO_DESTINATION;
+    return firstHallway + advance - distanceToHallWay;
+  }
+
+  // The piece is in the final hallway
+  if (isHallwayPosition(piece)) {
+    if (GOAL - piece < advance) return NO_DESTINATION;
+    return piece + advance;
+  }
+
+  // I cannot move a piece that has reached the goal
+  return NO_DESTINATION;
+}
+
+// Every amount of positions a piece can be asked to advance during a game
+static constexpr std::array<unsigned int, 8> TABULATED_ADVANCES{
+    1, 2, 3, 4, 5, 6, EXTRA_MOVEMENT_ON_GOAL, EXTRA_MOVEMENT_ON_KILL};
+static constexpr unsigned int N_ADVANCES = TABULATED_ADVANCES.size();
+
+// Index of the advance in TABULATED_ADVANCES, N_ADVANCES if it is not there
+static constexpr unsigned int advanceIndex(unsigned int advance) {
+  if (advance >= 1 && advance <= DICE_FACES) return advance - 1;
+  if (advance == EXTRA_MOVEMENT_ON_GOAL) return DICE_FACES;
+  if (advance == EXTRA_MOVEMENT_ON_KILL) return DICE_FACES + 1;
+  return N_ADVANCES;
+}
+
+// Destination of every piece of every player for every tabulated advance
+using DestinationTable =
+    std::array<std::array<std::array<std::uint8_t, N_ADVANCES>, GOAL + 1>,
+               N_PLAYERS>;
+
+static constexpr DestinationTable loadDestinationTable() {
+  DestinationTable table{};
+  for (PlayerNumber player = 1; player <= N_PLAYERS; player++) {
+    for (Position piece = HOME; piece <= GOAL; piece++) {
+      for (unsigned int i = 0; i < N_ADVANCES; i++) {
+        // Positions between the common ones and the hallway do not exist
+        Position destination =
+            (piece > totalPositions && piece < firstHallway)
+                ? NO_DESTINATION
+                : computeDestination(player, piece, TABULATED_ADVANCES[i]);
+        table[player - 1][piece][i] = static_cast<std::uint8_t>(destination);
+      }
+    }
+  }
+
+  return table;
+}
+
+static constexpr DestinationTable DESTINATION_TABLE = loadDestinationTable();
+
+// Same as computeDestination, but reading the table when possible
+static constexpr Position getDestination(PlayerNumber player, Position piece,
+                                         unsigned int advance) {
+  unsigned int index = advanceIndex(advance);
+  bool isTabulated{player >= 1 && player <= N_PLAYERS && piece <= GOAL &&
+                   index < N_ADVANCES};
+  if (!isTabulated) return computeDestination(player, piece, advance);
+
+  return DESTINATION_TABLE[player - 1][piece][index];
+}
+
+// Positions a piece needs to advance to get to the goal.
+// Pieces at home are counted from the initial position.
+static constexpr unsigned int computeDistanceToGoal(PlayerNumber player,
+                                                    Position piece) {
+  if (piece == HOME) piece = getPlayerInitialPosition(player);
+  if (isCommonPosition(piece)) {
+    return 1 + distanceToPosition(piece, getPlayerLastPosition(player)) +
+           hallwayLength;
+  }
+  return GOAL - piece;
+}
+
+using DistanceTable = std::array<std::array<std::uint8_t, GOAL + 1>, N_PLAYERS>;
+
+static constexpr DistanceTable loadDistanceToGoalTable() {
+  DistanceTable table{};
+  for (PlayerNumber player = 1; player <= N_PLAYERS; player++) {
+    for (Position piece = HOME; piece <= GOAL; piece++) {
+      if (piece > totalPositions && piece < firstHallway) continue;
+      table[player - 1][piece] =
+          static_cast<std::uint8_t>(computeDistanceToGoal(player, piece));
+    }
+  }
+
+  return table;
+}
+
+static constexpr DistanceTable DISTANCE_TO_GOAL_TABLE =
+    loadDistanceToGoalTable();
+
+// Same as computeDistanceToGoal for the players and positions that exist
+static constexpr unsigned int getDistanceToGoal(PlayerNumber player,
+                                                Position piece) {
+  return DISTANCE_TO_GOAL_TABLE[player - 1][piece];
+}
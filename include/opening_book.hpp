@@ -0,0 +1,76 @@
+#pragma once
+
+#include <array>      // for array
+#include <cstddef>    // for size_t
+#include <cstdint>    // for uint8_t
+#include <optional>   // for optional
+#include <stdexcept>  // for invalid_argument
+#include <string>     // for string
+#include <utility>    // for pair, move
+#include <vector>     // for vector
+
+#include "dices.hpp"                // for DicePairRoll
+#include "game.hpp"                 // for Game, ScoredPlay, Move, MAX_TURN_...
+#include "mapped_file.hpp"          // for MappedFile
+#include "table.hpp"                // for PlayerNumber
+#include "transposition_table.hpp"  // for TranspositionTable
+
+// Best plays of the most frequent early positions, searched offline with a
+// deep search, see tools/generate_opening_book.cpp.
+// The positions are keyed as the decisions of the transposition table, but
+// without the depth: the book keeps the depth all its plays were searched
+// with, and only serves the searches of that depth. As in the table,
+// the plays are stored from the side of player 1, so a position is stored
+// once for both players.
+// The file is a header followed by the entries sorted by key. It is mapped
+// into memory as it is, so opening it does not read nor parse the entries.
+class OpeningBook {
+ public:
+  // Maps the file written by write. Only the header and the size are checked,
+  // a file with a wrong one throws InvalidFile.
+  static OpeningBook open(const std::string& path);
+  // Writes the plays sorted by key. Every key must be made by key and every
+  // play searched with the depth.
+  static void write(
+      const std::string& path, unsigned int depth,
+      const std::vector<std::pair<TranspositionTable::Key, ScoredPlay>>&
+          plays);
+
+  // Key of the decision in the book, the same for every depth
+  static TranspositionTable::Key key(const Game::Turn::FinalState& state,
+                                     PlayerNumber player,
+                                     const DicePairRoll& dices,
+                                     unsigned int rollsInARow);
+
+  // Binary search of the decision in the book. Throws InvalidFile if the
+  // entries it finds could not have been written by write.
+  std::optional<ScoredPlay> probe(const TranspositionTable::Key& key) const;
+
+  std::size_t size() const { return nEntries; }
+  // Depth the plays were searched with
+  unsigned int depth() const { return searchDepth; }
+
+  struct InvalidFile : public std::invalid_argument {
+    using std::invalid_argument::invalid_argument;
+  };
+
+  // How every play is laid out in the file
+  struct Entry {
+    TranspositionTable::Key key;
+    double score;
+    std::uint8_t nMovements;
+    std::array<Move, MAX_TURN_MOVES> movements;
+    // Up to the alignment of the next entry
+    std::array<std::uint8_t, (8 - (1 + sizeof(Move) * MAX_TURN_MOVES) % 8) % 8>
+        padding;
+  };
+
+ private:
+  explicit OpeningBook(MappedFile file) : file(std::move(file)) {}
+
+  MappedFile file;
+  // Right after the header of the file
+  const Entry* entries{nullptr};
+  std::size_t nEntries{0};
+  unsigned int searchDepth{0};
+};
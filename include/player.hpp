@@ -1,26 +1,54 @@
 #pragma once
 
 #include <array>      // for array
-#include <set>        // for set
+#include <optional>   // for optional
 #include <stdexcept>  // for invalid_argument
 #include <string>     // for string
 #include <vector>     // for vector
 
-#include "table.hpp"  // for HOME, Position, PlayerNumber
+#include "board.hpp"       // for Board, SquareMask
+#include "game_state.hpp"  // for GameState
+#include "table.hpp"       // for HOME, Position, PlayerNumber
 
 class Player {
  public:
   using Pieces = std::array<Position, 4>;
 
   double punctuation() const;
+  // Punctuation of a player with all the pieces on the goal
+  static constexpr double WON_PUNCTUATION = -5000;
+  // Punctuation of a player with the given pieces, without building it
+  static double piecesPunctuation(PlayerNumber playerNumber,
+                                  const GameState::Pieces& pieces);
+  // Highest punctuation the player can have after moving its pieces forward
+  static double maxReachablePunctuation(PlayerNumber playerNumber,
+                                        const GameState::Pieces& pieces);
 
   // Checks whether all the pieces are on the goal
   bool hasWon() const;
 
-  // Moves the piece to the returned position
+  // Moves the piece to the returned position.
+  // Throws if the movement cannot be performed.
   Position movePiece(Position pieceToMove, unsigned int positionsToMove);
   Position movePiece(Position pieceToMove, unsigned int positionsToMove,
-                     const std::set<Position>& barriers);
+                     const SquareMask& barriers);
+
+  // Position the piece would get to, or nothing if it cannot be moved.
+  // Does not throw, so it is the one to use while generating movements.
+  std::optional<Position> destination(Position pieceToMove,
+                                      unsigned int positionsToMove,
+                                      const SquareMask& barriers = {}) const;
+  // Same as destination, but the piece must be one of the pieces of the player
+  // and they are counted on the board instead of looked for
+  static std::optional<Position> destination(PlayerNumber playerNumber,
+                                             Position pieceToMove,
+                                             unsigned int positionsToMove,
+                                             const Board& board,
+                                             const SquareMask& barriers);
+  // Moves the piece only if the movement can be performed
+  std::optional<Position> tryMovePiece(Position pieceToMove,
+                                       unsigned int positionsToMove,
+                                       const SquareMask& barriers = {});
 
   unsigned int countPiecesInPosition(Position targetPosition) const;
   bool canGoToInitialPosition() const;
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstddef>    // for size_t
+#include <iosfwd>     // for istream, ostream
+#include <stdexcept>  // for invalid_argument
+#include <string>     // for string
+
+#include "advisor.hpp"  // for Advisor, Query
+#include "game.hpp"     // for ScoredPlay
+
+// Text protocol to ask for many best plays through a stream.
+// Every line of the input is a query:
+//   <player> <dice> <dice> <4 pieces of player 1> <4 pieces of player 2>
+//   [rolls in a row]
+// Every line of the output answers the query on the same line:
+//   <score> [<player>:<origin>-<dest> ...]
+// or "error <message>" if the query could not be answered.
+// Empty lines are ignored.
+
+struct ParseError : public std::invalid_argument {
+  using std::invalid_argument::invalid_argument;
+};
+
+// Throws ParseError if the line is not a valid query
+Query parseQuery(const std::string& line);
+
+std::string formatPlay(const ScoredPlay& scoredPlay);
+
+struct StreamOptions {
+  // Queries searched at the same time
+  std::size_t batchSize{64};
+  // Queries read in advance while the previous ones are searched
+  std::size_t queueCapacity{1024};
+};
+
+// Answers every query until the input ends.
+// The input is read on its own thread while the queries already read are
+// searched, and every batch is written as soon as it is answered.
+// The input is not tied to any output while it is read.
+void analyzeStream(std::istream& input, std::ostream& output,
+                   Advisor& advisor, const StreamOptions& options = {});
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <atomic>     // for atomic
+#include <chrono>     // for steady_clock
+#include <cstddef>    // for size_t
+#include <stdexcept>  // for runtime_error
+
+// Limits of a search that has to answer on time.
+// It can be shared between threads.
+class SearchBudget {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  // Deepest search an iterative deepening gets to if no depth is given
+  static constexpr unsigned int DEFAULT_MAX_DEPTH = 32;
+
+  // Zero time or nodes means there is no limit on them
+  explicit SearchBudget(Clock::duration time, std::size_t nodes = 0,
+                        unsigned int maxDepth = DEFAULT_MAX_DEPTH);
+
+  // Starts counting the time and the nodes from now
+  void restart();
+
+  // Counts a searched node. Throws Exhausted once the budget is spent, so
+  // the search unwinds without storing unfinished results.
+  void spendNode();
+
+  bool isExhausted() const { return exhausted; }
+  std::size_t spentNodes() const { return nodes; }
+  unsigned int getMaxDepth() const { return maxDepth; }
+
+  struct Exhausted : public std::runtime_error {
+    using std::runtime_error::runtime_error;
+  };
+
+ private:
+  Clock::duration time;
+  std::size_t maxNodes;
+  unsigned int maxDepth;
+
+  Clock::time_point deadline;
+  std::atomic<std::size_t> nodes{0};
+  // Once a thread finds the budget spent, the rest stop too
+  std::atomic<bool> exhausted{false};
+};
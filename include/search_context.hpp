@@ -0,0 +1,38 @@
+#pragma once
+
+class EndgameTable;
+class OpeningBook;
+class SearchBudget;
+struct SearchStats;
+class ThreadPool;
+class TranspositionTable;
+
+// Resources shared by all the nodes of a search.
+// The context does not own any of them.
+struct SearchContext {
+  // Cache of the evaluated states, nullptr to disable it
+  TranspositionTable* transpositionTable{nullptr};
+
+  // Workers to split the search between, nullptr to search on one thread
+  ThreadPool* threadPool{nullptr};
+  // Nodes with at least this remaining depth split their children between the
+  // workers. Deeper nodes are too small to be worth it.
+  unsigned int minParallelDepth{1};
+
+  // Skip the branches that cannot change the best play.
+  // The result is the same, disabling it is only useful to compare.
+  bool pruning{true};
+
+  // Limits of the search, nullptr to search until the end
+  SearchBudget* budget{nullptr};
+
+  // Counters of the work done, nullptr to not collect them.
+  // They are only collected if the project is built with them.
+  SearchStats* stats{nullptr};
+
+  // Exact punctuations of the endgames, nullptr to use the heuristic ones
+  const EndgameTable* endgameTable{nullptr};
+
+  // Best plays searched offline, nullptr to always search them
+  const OpeningBook* openingBook{nullptr};
+};
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <array>    // for array
+#include <atomic>   // for atomic, memory_order_relaxed
+#include <chrono>   // for steady_clock, nanoseconds
+#include <cstddef>  // for size_t
+#include <ostream>  // for ostream
+
+// Counters of the work done by a search, to know where its time goes.
+// They are only collected when the project is built with PARCHIS_SEARCH_STATS
+// (cmake -DSEARCH_STATS=ON). Otherwise the search does not touch them and the
+// code that records them is compiled out.
+// It can be shared between threads.
+struct SearchStats {
+#ifdef PARCHIS_SEARCH_STATS
+  static constexpr bool ENABLED = true;
+#else
+  static constexpr bool ENABLED = false;
+#endif
+
+  using Counter = std::atomic<std::size_t>;
+  using Clock = std::chrono::steady_clock;
+
+  // Deeper nodes are counted on the last position
+  static constexpr unsigned int MAX_DEPTH = 8;
+  // Decision nodes searched with the given remaining depth. The root of a
+  // search of depth d is on position d and its children on d - 1.
+  std::array<Counter, MAX_DEPTH + 1> nodesPerDepth{};
+
+  // Turns generated for the decision nodes
+  Counter generatedTurns{0};
+  // Turns removed because another turn got to the same state
+  Counter duplicatedStates{0};
+  // Turns removed because they moved a barrier with double dices
+  Counter movedBarriers{0};
+  // Extra advances tried after getting to goal or eating a piece
+  Counter boostRecursions{0};
+
+  Counter leafEvaluations{0};
+
+  Counter cacheProbes{0};
+  Counter cacheHits{0};
+
+  // Decision nodes answered by the opening book
+  Counter bookHits{0};
+
+  // Memory of the nodes served by the arenas of the threads, and the blocks
+  // the arenas had to request to the system for it
+  Counter arenaAllocations{0};
+  Counter arenaBytes{0};
+  Counter arenaBlocks{0};
+
+  // Wall time of every phase, added over all the threads
+  std::atomic<Clock::rep> generationTime{0};
+  std::atomic<Clock::rep> orderingTime{0};
+
+  static void add(Counter& counter, std::size_t amount = 1) {
+    counter.fetch_add(amount, std::memory_order_relaxed);
+  }
+
+  std::size_t nodes() const;
+
+  void reset();
+
+  // Adds the time until it is destroyed to one of the phases
+  class Timer {
+   public:
+    // Does nothing if there is no phase to add the time to
+    explicit Timer(std::atomic<Clock::rep>* phase)
+        : phase(phase), start(phase ? Clock::now() : Clock::time_point{}) {}
+    ~Timer() {
+      if (phase) {
+        phase->fetch_add((Clock::now() - start).count(),
+                         std::memory_order_relaxed);
+      }
+    }
+
+    Timer(const Timer&) = delete;
+    Timer& operator=(const Timer&) = delete;
+
+   private:
+    std::atomic<Clock::rep>* phase;
+    Clock::time_point start;
+  };
+};
+
+std::ostream& operator<<(std::ostream& os, const SearchStats& stats);
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <array>       // for array
+#include <cstddef>     // for size_t
+#include <cstdint>     // for uint64_t
+#include <functional>  // for function
+#include <iosfwd>      // for ostream
+#include <string>      // for string
+#include <vector>      // for vector
+
+#include "dices.hpp"        // for DicePairRoll
+#include "fast_random.hpp"  // for FastRandom
+#include "game.hpp"         // for Game, Game::Turn
+#include "game_state.hpp"   // for N_PLAYERS
+#include "table.hpp"        // for PlayerNumber
+
+class ThreadPool;
+
+// Chooses one of the turns the player can do with the dices, which are the
+// roll number rollsInARow of the player in this turn.
+// Returns its index in turns, which is never empty.
+using Policy = std::function<std::size_t(
+    const Game& game, const std::vector<Game::Turn>& turns,
+    PlayerNumber player, const DicePairRoll& dices, unsigned int rollsInARow,
+    FastRandom& random)>;
+
+// Plays the best play of a search with the given depth.
+// A depth of 0 only looks at the state after the turn.
+// Every thread keeps a transposition table for all the searches it does, so
+// the positions that come up again in a game are not searched again.
+Policy searchPolicy(unsigned int depth);
+// Plays any of the turns
+Policy randomPolicy();
+// "random" or the depth of the search
+Policy makePolicy(const std::string& name);
+
+using Policies = std::array<Policy, N_PLAYERS>;
+
+struct GameResult {
+  // 0 if nobody won before the turns limit
+  PlayerNumber winner{0};
+  // Number of turns of both players. The rolls after a double are part of
+  // the same turn.
+  unsigned int turns{0};
+};
+
+// Plays a whole game, starting with the given player
+GameResult playGame(const Policies& policies, std::uint64_t seed,
+                    PlayerNumber firstPlayer = 1,
+                    unsigned int maxTurns = 1000);
+
+struct SimulationReport {
+  std::size_t games{0};
+  std::array<std::size_t, N_PLAYERS> wins{};
+  // Games that got to the turns limit
+  std::size_t unfinished{0};
+
+  std::size_t totalTurns{0};
+  unsigned int minTurns{0};
+  unsigned int maxTurns{0};
+
+  double seconds{0};
+
+  double winRate(PlayerNumber player) const;
+  double meanTurns() const;
+  double gamesPerSecond() const;
+};
+
+// Plays the games splitting them between the workers, if any.
+// Every game gets its own seed derived from the given one, and the players
+// take turns to start, so the report only depends on the seed.
+SimulationReport simulateGames(const Policies& policies, std::size_t nGames,
+                               std::uint64_t seed,
+                               ThreadPool* threadPool = nullptr,
+                               unsigned int maxTurns = 1000);
+
+std::ostream& operator<<(std::ostream& os, const SimulationReport& report);
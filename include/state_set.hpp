@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstddef>  // for size_t
+#include <cstdint>  // for uint64_t, uint32_t
+#include <vector>   // for vector
+
+// Set of canonical keys of states, see canonicalKey, with open addressing.
+// Clearing it does not touch the memory, so the same set can be reused to
+// remove the repeated turns of every node of a search.
+class StateSet {
+ public:
+  explicit StateSet(std::size_t capacity = DEFAULT_CAPACITY);
+
+  // Returns false if the key was already in the set
+  bool insert(std::uint64_t key);
+  void clear();
+
+  std::size_t size() const { return count; }
+
+  static constexpr std::size_t DEFAULT_CAPACITY = 256;
+
+ private:
+  struct Slot {
+    std::uint64_t key{0};
+    // The slot is only used if it was filled after the last clear
+    std::uint32_t generation{0};
+  };
+
+  // Doubles the capacity and inserts the keys again
+  void grow();
+
+  std::vector<Slot> slots;
+  std::uint32_t generation{1};
+  std::size_t count{0};
+};
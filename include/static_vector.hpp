@@ -0,0 +1,65 @@
+#pragma once
+
+#include <array>             // for array
+#include <cstddef>           // for size_t
+#include <cstdint>           // for uint8_t, UINT8_MAX
+#include <initializer_list>  // for initializer_list
+#include <stdexcept>         // for length_error
+#include <type_traits>       // for conditional_t
+
+// Vector with a fixed capacity stored inline, so it never allocates.
+// It is trivially copyable if T is. The size takes a single byte when the
+// capacity fits in it.
+template <typename T, std::size_t N>
+class StaticVector {
+ public:
+  using value_type = T;
+  using iterator = T*;
+  using const_iterator = const T*;
+
+  constexpr StaticVector() = default;
+  constexpr StaticVector(std::initializer_list<T> init) {
+    assign(init.begin(), init.end());
+  }
+
+  static constexpr std::size_t capacity() { return N; }
+  constexpr std::size_t size() const { return count; }
+  constexpr bool empty() const { return count == 0; }
+
+  constexpr void push_back(const T& value) {
+    if (count == N) throw std::length_error("StaticVector is full");
+    values[count++] = value;
+  }
+  constexpr void pop_back() { count--; }
+  // New elements are value initialized
+  constexpr void resize(std::size_t newSize) {
+    if (newSize > N) throw std::length_error("StaticVector is full");
+    for (std::size_t i = count; i < newSize; i++) values[i] = T{};
+    count = static_cast<SizeType>(newSize);
+  }
+  constexpr void clear() { count = 0; }
+  template <typename InputIt>
+  constexpr void assign(InputIt first, InputIt last) {
+    clear();
+    for (; first != last; first++) push_back(*first);
+  }
+
+  constexpr T& operator[](std::size_t i) { return values[i]; }
+  constexpr const T& operator[](std::size_t i) const { return values[i]; }
+  constexpr T& front() { return values[0]; }
+  constexpr const T& front() const { return values[0]; }
+  constexpr T& back() { return values[count - 1]; }
+  constexpr const T& back() const { return values[count - 1]; }
+
+  constexpr iterator begin() { return values.data(); }
+  constexpr iterator end() { return values.data() + count; }
+  constexpr const_iterator begin() const { return values.data(); }
+  constexpr const_iterator end() const { return values.data() + count; }
+
+ private:
+  using SizeType =
+      std::conditional_t<(N <= UINT8_MAX), std::uint8_t, std::size_t>;
+
+  std::array<T, N> values{};
+  SizeType count{0};
+};
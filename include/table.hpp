@@ -1,5 +1,7 @@
 #pragma once
 
+#include <stdexcept>  // for invalid_argument
+
 using Position = unsigned int;
 
 // Total amount of common positions where the pieces can be.
@@ -29,10 +31,28 @@ using PlayerNumber = unsigned int;
 
 // Returns the position where the player should move its pieces when it starts
 // playing
-Position getPlayerInitialPosition(PlayerNumber player);
+static constexpr Position getPlayerInitialPosition(PlayerNumber player) {
+  switch (player) {
+    case 1:
+      return 1;
+    case 2:
+      return 35;
+    default:
+      throw std::invalid_argument("Got a non existing player");
+  }
+}
 
 // Returns the position just before eneterig the last hallway to goal
-Position getPlayerLastPosition(PlayerNumber player);
+static constexpr Position getPlayerLastPosition(PlayerNumber player) {
+  switch (player) {
+    case 1:
+      return 64;
+    case 2:
+      return 30;
+    default:
+      throw std::invalid_argument("Got a non existing player");
+  }
+}
 
 // Returns whether a piece in this position can be eaten
 static constexpr bool isSafePosition(Position position) {
@@ -61,6 +81,27 @@ static constexpr bool isCommonPosition(Position position) {
   return (position >= 1 && position <= totalPositions);
 };
 
+// The board looks the same to both players once it is rotated half a turn:
+// the initial, last and safe positions of a player are the ones of the other
+// player rotated. Returns where a position goes with that rotation. Home, the
+// hallways and the goal belong to a player, so they do not move.
+static constexpr Position mirrorPosition(Position position) {
+  if (!isCommonPosition(position)) return position;
+  return (position + totalPositions / 2 - 1) % totalPositions + 1;
+}
+
+static_assert(mirrorPosition(getPlayerInitialPosition(1)) ==
+              getPlayerInitialPosition(2));
+static_assert(mirrorPosition(getPlayerLastPosition(1)) ==
+              getPlayerLastPosition(2));
+static_assert([] {
+  for (Position position = 1; position <= totalPositions; position++) {
+    if (isSafePosition(position) != isSafePosition(mirrorPosition(position)))
+      return false;
+  }
+  return true;
+}());
+
 // Returns whether a position is in the hallway, it does not include the goal
 static constexpr bool isHallwayPosition(Position position) {
   return position >= firstHallway && position <= finalHallway;
@@ -72,7 +113,26 @@ static constexpr bool isEatingPosition(Position position) {
 };
 
 // If the number is too big, take it back to the correct range
-Position correctPosition(Position position);
+static constexpr Position correctPosition(Position position) {
+  // If the position is in a common position and the number is bigger than it
+  // should, take it back to the range [1, totalPositions].
+  // This correction is not correct if the piece is on the hallway or on the
+  // goal.
+  if (position > totalPositions && position < firstHallway) {
+    return position - totalPositions;
+  }
+
+  return position;
+}
 
 // Returns the distance to get from one common position to other
-unsigned int distanceToPosition(Position ori, Position dest);
+static constexpr unsigned int distanceToPosition(Position ori, Position dest) {
+  if (!isCommonPosition(ori) || !isCommonPosition(dest)) {
+    throw std::invalid_argument("Distance between non common positions.");
+  }
+
+  if (dest >= ori)
+    return dest - ori;
+  else
+    return dest + totalPositions - ori;
+}
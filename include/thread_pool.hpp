@@ -0,0 +1,61 @@
+#pragma once
+
+#include <atomic>              // for atomic
+#include <condition_variable>  // for condition_variable
+#include <cstddef>             // for size_t
+#include <deque>               // for deque
+#include <functional>          // for function
+#include <memory>              // for shared_ptr, unique_ptr
+#include <mutex>               // for mutex
+#include <thread>              // for thread
+#include <vector>              // for vector
+
+// Pool of workers with a queue of jobs each.
+// A worker that runs out of jobs steals them from the other queues.
+class ThreadPool {
+ public:
+  // Use one worker per hardware thread if no number is given
+  explicit ThreadPool(unsigned int nThreads = 0);
+  ~ThreadPool();
+
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  unsigned int size() const {
+    return static_cast<unsigned int>(threads.size());
+  }
+
+  // Calls task(i) for every i in [0, count) and waits for all of them.
+  // The calling thread runs tasks too, so it is safe to call it from inside
+  // a task.
+  // If any task throws, the first exception is rethrown once all the tasks
+  // are done.
+  void parallelFor(std::size_t count,
+                   const std::function<void(std::size_t)>& task);
+
+ private:
+  // Tasks of a parallelFor call. The threads that get a job take tasks
+  // from the batch until there are none left.
+  struct Batch;
+  using Job = std::shared_ptr<Batch>;
+
+  struct Queue {
+    std::mutex mutex;
+    std::deque<Job> jobs;
+  };
+
+  void push(const Job& job);
+  // Takes a job nested deeper than the given level
+  bool popJob(Job& job, unsigned int minLevel);
+  void runJob(const Job& job);
+  void workerLoop(std::size_t queueIndex);
+
+  // One queue per worker plus one for the threads outside the pool
+  std::vector<std::unique_ptr<Queue>> queues;
+  std::vector<std::thread> threads;
+
+  std::atomic<std::size_t> pendingJobs{0};
+  std::mutex sleepMutex;
+  std::condition_variable wakeUp;
+  bool stopping{false};
+};
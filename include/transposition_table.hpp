@@ -0,0 +1,104 @@
+#pragma once
+
+#include <array>     // for array
+#include <atomic>    // for atomic
+#include <cstddef>   // for size_t
+#include <cstdint>   // for uint64_t, uint8_t
+#include <mutex>     // for mutex
+#include <optional>  // for optional
+#include <vector>    // for vector
+
+#include "dices.hpp"  // for DicePairRoll
+#include "game.hpp"   // for Game, Play, ScoredPlay, SearchWindow
+#include "table.hpp"  // for PlayerNumber
+
+// Cache of the positions already evaluated by the search.
+// Entries are keyed on the canonical state of the table, so positions reached
+// through different move orders or dice share the same entry.
+// The keys are taken from the side of player 1: the nodes where player 2
+// moves are mirrored first, see mirrorState, so both players share the
+// entries of the same position. The plays of those nodes are stored mirrored
+// too.
+// It can be shared between threads.
+class TranspositionTable {
+ public:
+  // Canonical description of a searched node.
+  // It is exact: two keys are equal only if they describe the same node.
+  struct Key {
+    // Pieces of both players in any order, see canonicalKey
+    std::uint64_t pieces{0};
+    // Last touched pieces, side to move, next player, rolls in a row,
+    // remaining depth and dices
+    std::uint64_t context{0};
+
+    bool operator==(const Key&) const = default;
+  };
+
+  // Key for the value of a state before the dices are rolled
+  static Key chanceKey(const Game::Turn::FinalState& state,
+                       PlayerNumber currentPlayer, PlayerNumber nextPlayer,
+                       unsigned int depth, unsigned int rollsInARow);
+
+  // Key for the best play of a player once the dices are known
+  static Key decisionKey(const Game::Turn::FinalState& state,
+                         PlayerNumber player, const DicePairRoll& dices,
+                         unsigned int depth, unsigned int rollsInARow);
+
+  // Whether the keys of the nodes where the player moves are taken from the
+  // mirrored state, so their plays have to be mirrored to be stored and to
+  // be used after they are found
+  static constexpr bool isMirrored(PlayerNumber player) { return player != 1; }
+
+  // What a stored score says about the real score of the node
+  enum class Bound : std::uint8_t {
+    EXACT,
+    // The real score is higher or equal
+    LOWER,
+    // The real score is lower or equal
+    UPPER,
+  };
+
+  // The table is made of buckets of two entries.
+  // The capacity is rounded down to a power of two.
+  explicit TranspositionTable(std::size_t capacity = DEFAULT_CAPACITY);
+
+  // Returns the stored result if the key is in the table with an exact score
+  std::optional<ScoredPlay> probe(const Key& key);
+  // Also returns bounds that are enough to know the score is out of the window
+  std::optional<ScoredPlay> probe(const Key& key, const SearchWindow& window);
+
+  // Stores the result of a search.
+  // The first entry of every bucket keeps the deepest search seen,
+  // the second one is always replaced.
+  void store(const Key& key, unsigned int depth, const ScoredPlay& result,
+             Bound bound = Bound::EXACT);
+
+  void clear();
+
+  std::size_t capacity() const { return entries.size(); }
+  std::size_t size() const { return usedEntries; }
+  std::size_t hits() const { return nHits; }
+  std::size_t probes() const { return nProbes; }
+
+  static constexpr std::size_t DEFAULT_CAPACITY = 1 << 16;
+
+ private:
+  struct Entry {
+    Key key;
+    ScoredPlay result;
+    Bound bound{Bound::EXACT};
+    std::uint8_t depth{0};
+    bool used{false};
+  };
+
+  // First entry of the bucket of the key
+  std::size_t bucket(const Key& key) const;
+  // Lock that protects the bucket
+  std::mutex& lock(std::size_t bucket);
+
+  std::vector<Entry> entries;
+  std::array<std::mutex, 64> locks;
+  std::atomic<std::size_t> usedEntries{0};
+  std::atomic<std::size_t> nHits{0};
+  std::atomic<std::size_t> nProbes{0};
+};
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <array>    // for array
+#include <cstdint>  // for uint64_t
+
+#include "fast_random.hpp"  // for FastRandom
+#include "game_state.hpp"   // for GameState, N_PLAYERS, N_PIECES
+#include "table.hpp"        // for GOAL, Position, PlayerNumber
+
+// Random keys for every position of the pieces and of the last touched piece
+// of every player.
+// The hash of a state adds the keys instead of xoring them, so it does not
+// depend on the order of the pieces and two pieces on the same position do
+// not cancel each other.
+struct ZobristKeys {
+  using PositionKeys = std::array<std::uint64_t, GOAL + 1>;
+
+  std::array<PositionKeys, N_PLAYERS> pieces{};
+  std::array<PositionKeys, N_PLAYERS> lastTouched{};
+};
+
+static constexpr ZobristKeys makeZobristKeys() {
+  FastRandom random(0x5EED);
+  ZobristKeys keys;
+  for (ZobristKeys::PositionKeys& playerKeys : keys.pieces) {
+    for (std::uint64_t& key : playerKeys) key = random.next();
+  }
+  for (ZobristKeys::PositionKeys& playerKeys : keys.lastTouched) {
+    for (std::uint64_t& key : playerKeys) key = random.next();
+  }
+  return keys;
+}
+
+static constexpr ZobristKeys ZOBRIST_KEYS = makeZobristKeys();
+
+static constexpr std::uint64_t zobristPiece(PlayerNumber player,
+                                            Position position) {
+  return ZOBRIST_KEYS.pieces[player - 1][position];
+}
+
+static constexpr std::uint64_t zobristLastTouched(PlayerNumber player,
+                                                  Position position) {
+  return ZOBRIST_KEYS.lastTouched[player - 1][position];
+}
+
+// Hash of the whole state. Game keeps it up to date on every movement.
+static constexpr std::uint64_t zobristHash(const GameState& state) {
+  std::uint64_t hash{0};
+  for (PlayerNumber player = 1; player <= N_PLAYERS; player++) {
+    for (Position piece : state.getPieces(player)) {
+      hash += zobristPiece(player, piece);
+    }
+    hash += zobristLastTouched(player, state.lastTouched[player - 1]);
+  }
+  return hash;
+}
@@ -0,0 +1,44 @@
+#include "advisor.hpp"
+
+#include "search_context.hpp"  // for SearchContext
+
+Advisor::Advisor(unsigned int depth, unsigned int nThreads,
+                 std::size_t cacheCapacity)
+    : depth(depth), threadPool(nThreads), transpositionTable(cacheCapacity) {}
+
+void Advisor::setEndgameTable(const EndgameTable* table) {
+  endgameTable = table;
+  transpositionTable.clear();
+}
+
+static ScoredPlay searchQuery(const Query& query, unsigned int depth,
+                              const SearchContext& context) {
+  Game game(query.state);
+  game.setSearchContext(&context);
+  return game.bestPlay(query.player, query.roll, query.rollsInARow, depth);
+}
+
+std::vector<ScoredPlay> Advisor::bestPlays(const std::vector<Query>& queries) {
+  std::vector<ScoredPlay> plays(queries.size());
+
+  // With enough queries to keep every worker busy, each query is searched on
+  // a single thread so it can be pruned. The few queries of a small batch
+  // split their search between the workers instead.
+  SearchContext context{&transpositionTable};
+  context.endgameTable = endgameTable;
+  context.openingBook = openingBook;
+  if (queries.size() < threadPool.size()) {
+    context.threadPool = &threadPool;
+    context.minParallelDepth = 2;
+  }
+
+  threadPool.parallelFor(queries.size(), [&](std::size_t i) {
+    plays[i] = searchQuery(queries[i], depth, context);
+  });
+
+  return plays;
+}
+
+ScoredPlay Advisor::bestPlay(const Query& query) {
+  return bestPlays({query}).front();
+}
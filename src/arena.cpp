@@ -0,0 +1,76 @@
+#include "arena.hpp"
+
+#include <algorithm>  // for max
+#include <cassert>    // for assert
+#include <memory>     // for align
+
+Arena::Arena(std::size_t blockSize) : blockSize(blockSize) {}
+
+Arena& Arena::local() {
+  static thread_local Arena arena;
+  return arena;
+}
+
+void* Arena::do_allocate(std::size_t bytes, std::size_t alignment) {
+  counters.allocations++;
+  counters.bytes += bytes;
+
+  // Look for space from the top, the blocks that are too small are skipped
+  for (; topBlock < blocks.size(); topBlock++, topOffset = 0) {
+    Block& block = blocks[topBlock];
+    void* memory = block.memory.get() + topOffset;
+    std::size_t space = block.size - topOffset;
+    if (std::align(alignment, bytes, memory, space)) {
+      topOffset = block.size - space + bytes;
+      return memory;
+    }
+  }
+
+  // There is no space left, so add a block that surely fits it
+  std::size_t size = std::max(blockSize, bytes + alignment);
+  blocks.push_back({std::unique_ptr<std::byte[]>(new std::byte[size]), size});
+  counters.blocks++;
+
+  Block& block = blocks.back();
+  void* memory = block.memory.get();
+  std::size_t space = block.size;
+  std::align(alignment, bytes, memory, space);
+  topOffset = block.size - space + bytes;
+  return memory;
+}
+
+std::size_t Arena::used() const {
+  std::size_t total = topOffset;
+  for (std::size_t i = 0; i < topBlock && i < blocks.size(); i++) {
+    total += blocks[i].size;
+  }
+  return total;
+}
+
+std::size_t Arena::capacity() const {
+  std::size_t total = 0;
+  for (const Block& block : blocks) total += block.size;
+  return total;
+}
+
+Arena::Scope::Scope(Arena& arena)
+    : arena(arena),
+      outermost(arena.openScopes == 0),
+      block(arena.topBlock),
+      offset(arena.topOffset),
+      start(arena.counters) {
+  arena.openScopes++;
+}
+
+Arena::Scope::~Scope() {
+  assert(arena.openScopes > 0);
+  arena.openScopes--;
+  arena.topBlock = block;
+  arena.topOffset = offset;
+}
+
+Arena::Stats Arena::Scope::stats() const {
+  const Stats& now = arena.counters;
+  return {now.allocations - start.allocations, now.bytes - start.bytes,
+          now.blocks - start.blocks};
+}
@@ -0,0 +1,319 @@
+#include "endgame_table.hpp"
+
+#include <algorithm>    // for max, min, sort, stable_sort
+#include <cmath>        // for abs, INFINITY
+#include <cstdint>      // for uint32_t
+#include <cstring>      // for memcpy
+#include <fstream>      // for ofstream
+#include <functional>   // for function
+#include <numeric>      // for accumulate
+#include <optional>     // for optional
+#include <type_traits>  // for is_trivially_copyable_v
+#include <utility>      // for move
+#include <vector>       // for vector
+
+#include "dices.hpp"  // for getUnorderedRollsProb, averageDiceRoll
+#include "game.hpp"   // for Game
+#include "table.hpp"  // for GOAL, firstHallway, Position
+
+// Distances to goal of the pieces of a player, sorted
+using Distances = std::array<unsigned int, N_PIECES>;
+
+static Distances toDistances(const GameState::Pieces& pieces) {
+  Distances distances;
+  for (std::size_t i = 0; i < N_PIECES; i++) {
+    distances[i] = GOAL - pieces[i];
+  }
+  std::sort(distances.begin(), distances.end());
+  return distances;
+}
+
+static std::size_t toIndex(const Distances& distances) {
+  std::size_t index = 0;
+  for (unsigned int distance : distances) {
+    index = index * EndgameTable::N_DISTANCES + distance;
+  }
+  return index;
+}
+
+// All the positions of the table, in the order they are saved
+static std::vector<Distances> allPositions() {
+  std::vector<Distances> positions;
+  Distances distances;
+  std::function<void(std::size_t, unsigned int)> fill =
+      [&](std::size_t piece, unsigned int lowest) {
+        if (piece == N_PIECES) {
+          positions.push_back(distances);
+          return;
+        }
+        for (unsigned int distance = lowest;
+             distance < EndgameTable::N_DISTANCES; distance++) {
+          distances[piece] = distance;
+          fill(piece + 1, distance);
+        }
+      };
+  fill(0, 0);
+  return positions;
+}
+
+// Number of the sorted position in the order of allPositions, where it is
+// kept
+static std::size_t toNumber(const Distances& distances) {
+  static const std::vector<std::size_t> numbers = [] {
+    std::vector<Distances> positions = allPositions();
+    std::vector<std::size_t> numbers(toIndex(positions.back()) + 1);
+    for (std::size_t i = 0; i < positions.size(); i++) {
+      numbers[toIndex(positions[i])] = i;
+    }
+    return numbers;
+  }();
+  return numbers[toIndex(distances)];
+}
+
+// The first player has the pieces and the second one has already won, so it
+// does not get in the way
+static Game makeGame(const Distances& distances) {
+  GameState state;
+  for (std::size_t i = 0; i < N_PIECES; i++) {
+    state.pieces[0][i] = GOAL - distances[i];
+    state.pieces[1][i] = GOAL;
+  }
+  state.lastTouched = {state.pieces[0][0], GOAL};
+  return Game(state);
+}
+
+// Highest punctuation of the entries of all the positions
+static double maxEntriesPunctuation(const EndgameTable::Entry* entries) {
+  double highest{0.0};
+  for (std::size_t i = 0; i < EndgameTable::N_POSITIONS; i++) {
+    highest = std::max(highest, entries[i].punctuation);
+  }
+  return highest;
+}
+
+// Rolls in a row the player can have before rolling
+static constexpr unsigned int MAX_ROLLS_IN_A_ROW =
+    EndgameTable::MAX_ROLLS_IN_A_ROW;
+using RollsToFinish = std::array<double, MAX_ROLLS_IN_A_ROW>;
+
+// Precision of the expected number of rolls
+static constexpr double ROLLS_TOLERANCE = 1e-12;
+
+EndgameTable EndgameTable::solve() {
+  // The pieces only move forward, so the turns always get to positions
+  // closer to the goal, which are solved before
+  std::vector<Distances> positions = allPositions();
+  auto totalDistance = [](const Distances& distances) {
+    return std::accumulate(distances.begin(), distances.end(), 0u);
+  };
+  std::stable_sort(positions.begin(), positions.end(),
+                   [&](const Distances& first, const Distances& second) {
+                     return totalDistance(first) < totalDistance(second);
+                   });
+
+  // Expected rolls to finish, depending on the rolls in a row of the next one
+  std::vector<RollsToFinish> rollsToFinish(N_INDICES);
+  std::vector<Entry> entries(N_POSITIONS);
+  std::vector<FinishedWithin> finishedWithin(N_POSITIONS);
+
+  constexpr UnorderedRollsProb rolls{getUnorderedRollsProb()};
+  std::vector<Game::Turn> turns;
+  for (const Distances& position : positions) {
+    std::size_t index = toIndex(position);
+    FinishedWithin& within = finishedWithin[toNumber(position)];
+    // Every piece is on the goal, there is nothing left to roll
+    if (totalDistance(position) == 0) {
+      for (auto& byTurn : within) byTurn.fill(1.0);
+      continue;
+    }
+
+    // Rolls to finish after the best turn of every roll. Empty if the player
+    // cannot move and stays on this position.
+    std::array<std::array<std::optional<double>, rolls.size()>,
+               MAX_ROLLS_IN_A_ROW>
+        afterBestTurn;
+    // Number of the position the best turn gets to
+    std::array<std::array<std::size_t, rolls.size()>, MAX_ROLLS_IN_A_ROW>
+        bestTurn;
+    // Rolls in a row of the next roll
+    std::array<std::array<unsigned int, rolls.size()>, MAX_ROLLS_IN_A_ROW>
+        nextRollsInARow;
+    double maxReachable{0.0};
+
+    Game game = makeGame(position);
+    for (unsigned int inARow = 0; inARow < MAX_ROLLS_IN_A_ROW; inARow++) {
+      for (std::size_t i = 0; i < rolls.size(); i++) {
+        const DicePairRoll& roll = rolls[i].first;
+        bool isDouble = roll.first == roll.second;
+        unsigned int nextInARow =
+            isDouble && inARow + 1 < MAX_ROLLS_IN_A_ROW ? inARow + 1 : 0;
+        nextRollsInARow[inARow][i] = nextInARow;
+
+        bestTurn[inARow][i] = toNumber(position);
+        game.generateTurns(1, roll, inARow + 1, turns);
+        for (const Game::Turn& turn : turns) {
+          Distances next = toDistances(turn.finalState.getPieces(1));
+          if (next == position) continue;
+          std::size_t nextIndex = toIndex(next);
+          double rollsAfterTurn = rollsToFinish[nextIndex][nextInARow];
+          std::optional<double>& best = afterBestTurn[inARow][i];
+          if (!best || rollsAfterTurn < *best) {
+            best = rollsAfterTurn;
+            bestTurn[inARow][i] = toNumber(next);
+          }
+          maxReachable = std::max(
+              maxReachable, entries[toNumber(next)].maxReachablePunctuation);
+        }
+      }
+    }
+
+    // The rolls that do not move the pieces leave the player on this
+    // position, so its value depends on itself. Iterate until it converges.
+    RollsToFinish& current = rollsToFinish[index];
+    double change = INFINITY;
+    while (change > ROLLS_TOLERANCE) {
+      RollsToFinish updated;
+      for (unsigned int inARow = 0; inARow < MAX_ROLLS_IN_A_ROW; inARow++) {
+        updated[inARow] = 1;
+        for (std::size_t i = 0; i < rolls.size(); i++) {
+          const std::optional<double>& best = afterBestTurn[inARow][i];
+          updated[inARow] += rolls[i].second *
+                             (best ? *best
+                                   : current[nextRollsInARow[inARow][i]]);
+        }
+      }
+      change = 0;
+      for (unsigned int inARow = 0; inARow < MAX_ROLLS_IN_A_ROW; inARow++) {
+        change = std::max(change, std::abs(updated[inARow] - current[inARow]));
+      }
+      current = updated;
+    }
+
+    double punctuation = current[0] * averageDiceRoll;
+    entries[toNumber(position)] = {punctuation,
+                                   std::max(punctuation, maxReachable)};
+
+    // The same best turns finish within a number of turns if the position
+    // they get to finishes within the rest of them. A double keeps the turn
+    // going, so the next roll is made in the same turn.
+    for (auto& byTurn : within) byTurn[0] = 0.0;
+    for (unsigned int turn = 1; turn <= EndgameTable::MAX_TURNS; turn++) {
+      // A double gets to the next rolls in a row of the same turn, so they
+      // are solved first
+      for (unsigned int inARow = MAX_ROLLS_IN_A_ROW; inARow-- > 0;) {
+        double finished{0.0};
+        for (std::size_t i = 0; i < rolls.size(); i++) {
+          const FinishedWithin& next = finishedWithin[bestTurn[inARow][i]];
+          unsigned int nextInARow = nextRollsInARow[inARow][i];
+          finished += rolls[i].second * (nextInARow == 0
+                                             ? next[0][turn - 1]
+                                             : next[nextInARow][turn]);
+        }
+        within[inARow][turn] = finished;
+      }
+    }
+  }
+
+  EndgameTable table;
+  table.solvedEntries = std::move(entries);
+  table.solvedFinishedWithin = std::move(finishedWithin);
+  table.entries = table.solvedEntries.data();
+  table.finishedWithin = table.solvedFinishedWithin.data();
+  table.highestPunctuation = maxEntriesPunctuation(table.entries);
+  return table;
+}
+
+// Written at the start of the file, followed by the entries of all the
+// positions and then their chances of finishing, both in the order of
+// allPositions
+struct FileHeader {
+  std::array<char, 8> magic;
+  std::uint32_t version;
+  std::uint32_t positions;
+};
+
+static constexpr std::array<char, 8> FILE_MAGIC{'P', 'A', 'R', 'C',
+                                                'H', 'I', 'S', 'E'};
+// Version 2 adds the chances of finishing within every number of turns.
+// Version 3 keeps only the sorted positions, so the file is used as it is.
+static constexpr std::uint32_t FILE_VERSION = 3;
+
+// The file is used right from the memory it is mapped to
+static_assert(std::is_trivially_copyable_v<EndgameTable::Entry>);
+static_assert(sizeof(FileHeader) % alignof(EndgameTable::Entry) == 0);
+static_assert(sizeof(EndgameTable::Entry) % alignof(double) == 0);
+
+EndgameTable EndgameTable::load(const std::string& path) {
+  std::optional<MappedFile> file = MappedFile::open(path);
+  if (!file) throw InvalidFile("Cannot open the endgame table " + path);
+
+  FileHeader header;
+  if (file->size() < sizeof(header)) {
+    throw InvalidFile(path + " is not an endgame table");
+  }
+  std::memcpy(&header, file->data(), sizeof(header));
+  if (header.magic != FILE_MAGIC) {
+    throw InvalidFile(path + " is not an endgame table");
+  }
+  if (header.version != FILE_VERSION || header.positions != N_POSITIONS) {
+    throw InvalidFile(path + " is an endgame table of another version");
+  }
+  if (file->size() != sizeof(header) + N_POSITIONS * (sizeof(Entry) +
+                                                      sizeof(FinishedWithin))) {
+    throw InvalidFile("The endgame table " + path + " is truncated");
+  }
+
+  EndgameTable table;
+  table.file = std::move(file);
+  const char* begin = table.file->data() + sizeof(header);
+  table.entries = reinterpret_cast<const Entry*>(begin);
+  table.finishedWithin = reinterpret_cast<const FinishedWithin*>(
+      begin + N_POSITIONS * sizeof(Entry));
+  table.highestPunctuation = maxEntriesPunctuation(table.entries);
+  return table;
+}
+
+void EndgameTable::save(const std::string& path) const {
+  std::ofstream file(path, std::ios::binary);
+  FileHeader header{FILE_MAGIC, FILE_VERSION, N_POSITIONS};
+  file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  file.write(reinterpret_cast<const char*>(entries),
+             N_POSITIONS * sizeof(Entry));
+  file.write(reinterpret_cast<const char*>(finishedWithin),
+             N_POSITIONS * sizeof(FinishedWithin));
+  if (!file) throw InvalidFile("Cannot write the endgame table " + path);
+}
+
+bool EndgameTable::covers(const GameState::Pieces& pieces) {
+  bool allOnGoal = true;
+  for (Position piece : pieces) {
+    if (piece < firstHallway) return false;
+    allOnGoal = allOnGoal && piece == GOAL;
+  }
+  return !allOnGoal;
+}
+
+const EndgameTable::Entry& EndgameTable::at(
+    const GameState::Pieces& pieces) const {
+  return entries[toNumber(toDistances(pieces))];
+}
+
+double EndgameTable::winProbability(const GameState::Pieces& rolling,
+                                    unsigned int rollsInARow,
+                                    const GameState::Pieces& other) const {
+  auto within = [this](const GameState::Pieces& pieces)
+                    -> const FinishedWithin& {
+    return finishedWithin[toNumber(toDistances(pieces))];
+  };
+  unsigned int inARow = std::min(rollsInARow, MAX_ROLLS_IN_A_ROW) - 1;
+  const auto& first = within(rolling)[inARow];
+  const auto& second = within(other)[0];
+
+  // The rolling player wins if it finishes in a turn the other player has
+  // not finished yet, or if it has already finished
+  double probability{first[0]};
+  for (unsigned int turn = 1; turn <= MAX_TURNS; turn++) {
+    probability += (first[turn] - first[turn - 1]) * (1 - second[turn - 1]);
+  }
+  return probability;
+}
@@ -1,468 +1,510 @@
 #include "game.hpp"
 
-#include <algorithm>  // for find, remove_if
-#include <array>      // for array
-#include <cmath>      // for INFINITY
-#include <iterator>   // for move_iterator, next, make_move_iterator
-#include <set>        // for set, operator==, erase_if, set<>::const_iterator
-#include <sstream>    // for operator<<, ostringstream, basic_ostream, basi...
-#include <stdexcept>  // for invalid_argument, logic_error
-
-#include "player.hpp"  // for Player, Player::WrongMove, Player::PieceNotFound
-#include "table.hpp"   // for HOME, Position, PlayerNumber, getPlayerInitial...
-
-static constexpr unsigned int EXTRA_MOVEMENT_ON_GOAL = 10;
-static constexpr unsigned int EXTRA_MOVEMENT_ON_KILL = 20;
+#include <algorithm>         // for find, max, min, stable_sort, count_if
+#include <array>             // for array
+#include <cassert>           // for assert
+#include <cmath>             // for INFINITY, nextafter
+#include <cstddef>           // for size_t
+#include <cstdint>           // for uint64_t, UINT64_MAX
+#include <functional>        // for function
+#include <initializer_list>  // for initializer_list
+#include <iterator>          // for next, rbegin, rend
+#include <memory_resource>   // for vector
+#include <optional>          // for optional, nullopt
+#include <sstream>           // for operator<<, ostringstream, basic_ostream
+#include <stdexcept>         // for invalid_argument, logic_error
+
+#include "arena.hpp"                // for Arena
+#include "endgame_table.hpp"        // for EndgameTable
+#include "opening_book.hpp"         // for OpeningBook
+#include "player.hpp"               // for Player, Player::WrongMove, Playe...
+#include "search_budget.hpp"        // for SearchBudget
+#include "search_context.hpp"       // for SearchContext
+#include "search_stats.hpp"         // for SearchStats
+#include "state_set.hpp"            // for StateSet
+#include "static_vector.hpp"        // for StaticVector
+#include "table.hpp"                // for HOME, Position, PlayerNumber, ge...
+#include "thread_pool.hpp"          // for ThreadPool
+#include "transposition_table.hpp"  // for TranspositionTable
+#include "zobrist.hpp"              // for zobristHash, zobristPiece, zobr...
 
 static constexpr Game::Players loadPlayers() {
   return {Player({1, {HOME, HOME, HOME, HOME}}),
           Player({2, {HOME, HOME, HOME, HOME}})};
 }
 
-static std::set<Position> loadBarriers(const Game::Players& players) {
-  std::set<Position> notEmptyPositions{};
-  std::set<Position> barriers{};
-
+static GameState loadState(const Game::Players& players) {
+  GameState state;
   for (const Player& player : players) {
-    for (const Position piece : player.pieces) {
-      // If the position cannot have a barrier, go on
-      if (!isCommonPosition(piece)) continue;
-
-      // Check I know there is another piece on this position
-      if (notEmptyPositions.find(piece) != notEmptyPositions.end()) {
-        // then I know this second piece creates a barrier.
-        barriers.insert(piece);
-      } else {
-        // It is the first piece I see on this position,
-        // so I store it in case I see another piece in this position
-        notEmptyPositions.insert(piece);
-      }
+    GameState::Pieces& pieces = state.getPieces(player.playerNumber);
+    for (unsigned int i = 0; i < player.pieces.size(); i++) {
+      pieces[i] = player.pieces[i];
     }
+
+    // If no other information is given,
+    // I pick the last touched piece is the first one
+    state.lastTouched[player.playerNumber - 1] = pieces.front();
   }
 
-  return barriers;
+  return state;
 }
 
-Game::Game() : players(loadPlayers()), barriers(loadBarriers(players)) {}
-
-Game::Game(const Players& players)
-    : players(players), barriers(loadBarriers(players)){};
-
-Game::Game(const Turn::FinalState& state)
-    : players(state.players),
-      lastTouched(state.lastTouched),
-      barriers(loadBarriers(players)){};
-
-static Player& getPlayer(Game::Players& players, PlayerNumber player) {
-  switch (player) {
-    case 1:
-    case 2:
-      return players[player - 1];
-    default:
-      throw std::invalid_argument("Got a non existing player");
-      break;
-  }
-};
-
-static Player& getNextPlayer(Game::Players& players, PlayerNumber player) {
-  switch (player) {
-    case 1:
-      return players[1];
-    case 2:
-      return players[0];
-    default:
-      throw std::invalid_argument("Got a non existing player");
-      break;
+static Board loadBoard(const GameState& state) {
+  Board board;
+  for (PlayerNumber player = 1; player <= N_PLAYERS; player++) {
+    for (const Position piece : state.getPieces(player)) {
+      // The hallways and the goal are ignored by the board
+      board.add(player, piece);
+    }
   }
-};
 
-const Player& getPlayer(const Game::Players& players, PlayerNumber player) {
-  return const_cast<const Player&>(
-      getPlayer(const_cast<Game::Players&>(players), player));
-};
+  return board;
+}
 
-const Player& Game::getPlayer(PlayerNumber player) const {
-  return const_cast<const Player&>(const_cast<Game*>(this)->getPlayer(player));
-};
+static std::array<double, N_PLAYERS> loadPunctuations(const GameState& state) {
+  std::array<double, N_PLAYERS> punctuations;
+  for (PlayerNumber player = 1; player <= N_PLAYERS; player++) {
+    punctuations[player - 1] =
+        Player::piecesPunctuation(player, state.getPieces(player));
+  }
 
-Player& Game::getPlayer(PlayerNumber player) {
-  return ::getPlayer(players, player);
-};
+  return punctuations;
+}
 
-const Player& Game::getNextPlayer(PlayerNumber player) const {
-  return const_cast<const Player&>(
-      const_cast<Game*>(this)->getNextPlayer(player));
-};
+Game::Game() : Game(loadPlayers()) {}
 
-Player& Game::getNextPlayer(PlayerNumber player) {
-  return ::getNextPlayer(players, player);
-};
+Game::Game(const Players& players)
+    : state(loadState(players)),
+      board(loadBoard(state)),
+      punctuations(loadPunctuations(state)),
+      hash(zobristHash(state)){};
 
-static Move constructMove(const Player& oldPlayer, const Player& newPlayer) {
-  if (oldPlayer.playerNumber != newPlayer.playerNumber) {
-    std::ostringstream oss;
-    oss << "Old player and new player must have same id. "
-        << oldPlayer.playerNumber << " and " << newPlayer.playerNumber
-        << " were given instead.";
+Game::Game(const Turn::FinalState& state)
+    : state(state),
+      board(loadBoard(state)),
+      punctuations(loadPunctuations(state)),
+      hash(zobristHash(state)){};
 
-    throw std::invalid_argument(oss.str());
+static void checkPlayer(PlayerNumber player) {
+  if (player < 1 || player > N_PLAYERS) {
+    throw std::invalid_argument("Got a non existing player");
   }
+}
 
-  const auto& oldPieces = oldPlayer.pieces;
-  const auto& newPieces = newPlayer.pieces;
+static PlayerNumber nextPlayerNumber(PlayerNumber player) {
+  checkPlayer(player);
+  return player % N_PLAYERS + 1;
+}
 
-  for (int i = 0; i < oldPieces.size(); i++) {
-    if (oldPieces[i] != newPieces[i]) {
-      return Move{newPlayer.playerNumber, oldPieces[i], newPieces[i]};
-    }
-  }
+static Player makePlayer(const GameState& state, PlayerNumber player) {
+  checkPlayer(player);
 
-  std::ostringstream oss;
-  oss << "No different pieces were found";
-  throw std::invalid_argument(oss.str());
+  Player madePlayer{player};
+  const GameState::Pieces& pieces = state.getPieces(player);
+  std::copy(pieces.begin(), pieces.end(), madePlayer.pieces.begin());
+  return madePlayer;
 }
 
-static std::vector<Game::Turn> ulteriorMovementsWithBoost(
-    const Player& playerToMove,
-    MovementsSequence::const_iterator advances_begin,
-    MovementsSequence::const_iterator advances_end, const Game& game,
-    unsigned int boostAdvance) {
-  // Get the movements I have to do and add the boost
-  MovementsSequence nextMovements;
-  nextMovements.push_back(boostAdvance);
-  nextMovements.insert(nextMovements.end(), advances_begin, advances_end);
-
-  // Return the sequence of movements that can be done with this sequence of
-  // advances
-  auto movementsWithBoost{
-      game.allPossibleStatesFromSequence(playerToMove, nextMovements)};
-  return movementsWithBoost;
+static bool hasWon(const GameState& state, PlayerNumber player) {
+  const GameState::Pieces& pieces = state.getPieces(player);
+  return std::all_of(pieces.begin(), pieces.end(),
+                     [](Position piece) { return piece == GOAL; });
 }
 
-static std::vector<Game::Turn> ulteriorMovements(
-    const Player& playerToMove, const MovementsSequence& advances,
-    const Game& game, bool gotToGoal, bool haveEaten) {
-  // Discard the already performed advance
-  auto nextAdvance{std::next(advances.begin())};
+Player Game::getPlayer(PlayerNumber player) const {
+  return makePlayer(state, player);
+};
 
-  if (gotToGoal) {
-    // Sequence of movements adding the boost
-    auto movementsWithGoalBoost =
-        ulteriorMovementsWithBoost(playerToMove, nextAdvance, advances.end(),
-                                   game, EXTRA_MOVEMENT_ON_GOAL);
-    // If the vector is empty, boost cannot be performed;
-    // but the rest of the dices must be executed. Cannot return.
-    if (!movementsWithGoalBoost.empty()) return movementsWithGoalBoost;
-  }
-  if (haveEaten) {
-    // Sequence of movements adding the boost
-    auto movementsWithKillBoost =
-        ulteriorMovementsWithBoost(playerToMove, nextAdvance, advances.end(),
-                                   game, EXTRA_MOVEMENT_ON_KILL);
-    // If the vector is empty, boost cannot be performed;
-    // but the rest of the dices must be executed. Cannot return.
-    if (!movementsWithKillBoost.empty()) return movementsWithKillBoost;
-  }
+Player Game::getNextPlayer(PlayerNumber player) const {
+  return makePlayer(state, nextPlayerNumber(player));
+};
 
-  // If there are no more advances, return empty vector
-  if (nextAdvance == advances.end()) return {};
+Game::Players Game::getPlayers() const {
+  return {getPlayer(1), getPlayer(2)};
+}
 
-  return game.allPossibleStatesFromSequence(playerToMove,
-                                            {nextAdvance, advances.end()});
+// Counters of the search, if they are built and the search collects them
+static SearchStats* getSearchStats(const Game& game) {
+  if constexpr (!SearchStats::ENABLED) return nullptr;
+  const SearchContext* context = game.getSearchContext();
+  return context ? context->stats : nullptr;
 }
 
-static bool canTakeOutPieces(const Player& currentPlayer) {
+static bool canTakeOutPieces(const Board& board, PlayerNumber currentPlayer) {
   // Check I have pieces to take out from home
-  auto homePieces = currentPlayer.indicesForHomePieces();
-  bool hasPiecesAtHome = !homePieces.empty();
+  bool hasPiecesAtHome = board.count(currentPlayer, HOME) > 0;
   if (!hasPiecesAtHome) return false;
 
   // Check on the inital position the is space for one more piece
   // Only need to check I have not two pieces of mine on the initial position
-  Position initialPosition =
-      getPlayerInitialPosition(currentPlayer.playerNumber);
+  Position initialPosition = getPlayerInitialPosition(currentPlayer);
   bool isSpaceInInitialPosition =
-      currentPlayer.countPiecesInPosition(initialPosition) < 2;
+      board.count(currentPlayer, initialPosition) < 2;
 
   return isSpaceInInitialPosition;
 }
 
-static std::vector<MovementsSequence> movementsSequences(
-    const Player& currentPlayer, const DicePairRoll& dices) {
+// Advances left to perform in a turn. The next one is on the back, so it is
+// popped and the boosts are pushed without moving the rest.
+using Advances = MovementsSequence;
+
+// Advances to perform in the given order
+static Advances makeAdvances(std::initializer_list<unsigned int> sequence) {
+  Advances advances;
+  for (auto it = std::rbegin(sequence); it != std::rend(sequence); it++) {
+    advances.push_back(*it);
+  }
+  return advances;
+}
+
+static StaticVector<Advances, 2> movementsSequences(
+    const Board& board, PlayerNumber currentPlayer,
+    const DicePairRoll& dices) {
+  StaticVector<Advances, 2> sequences;
+
   // If we can take out a piece we must move the 5 first of all
-  if (canTakeOutPieces(currentPlayer)) {
+  if (canTakeOutPieces(board, currentPlayer)) {
     if (dices.first + dices.second == OUT_OF_HOME)
-      return {{OUT_OF_HOME}};
+      sequences.push_back(makeAdvances({OUT_OF_HOME}));
     else if (dices.first == OUT_OF_HOME)
-      return {{dices.first, dices.second}};
+      sequences.push_back(makeAdvances({dices.first, dices.second}));
     else if (dices.second == OUT_OF_HOME)
-      return {{dices.second, dices.first}};
+      sequences.push_back(makeAdvances({dices.second, dices.first}));
+    if (!sequences.empty()) return sequences;
   }
 
-  std::vector<MovementsSequence> movements;
-
   // Regular case, no mandatory movements
-  movements.push_back({dices.first, dices.second});
+  sequences.push_back(makeAdvances({dices.first, dices.second}));
   if (dices.first != dices.second)
-    movements.push_back({dices.second, dices.first});
-  return movements;
-}
-
-static Player* eatenPlayerOnSafePosition(const Player& eater,
-                                         Game::Players& players,
-                                         Position destPosition) {
-  Player* eaten{nullptr};
-  unsigned int piecesCounter = 0;
-  // I must check there are three pieces on this position and return the enemy
-  // who is here
-  for (Player& player : players) {
-    // If any of the pieces of this player is in the same position,
-    // I have eaten it
-    for (Position piece : player.pieces) {
-      if (piece != destPosition) continue;
-
-      // Count a piece that is on this position
-      piecesCounter += 1;
-      // If the piece is from an enemy, store it
-      if (player.playerNumber != eater.playerNumber) {
-        eaten = &player;
-      }
-    }
+    sequences.push_back(makeAdvances({dices.second, dices.first}));
+  return sequences;
+}
+
+// Rival of the eater with a piece on the position
+static PlayerNumber rivalOnPosition(PlayerNumber eater, const Board& board,
+                                    Position position) {
+  PlayerNumber rival{0};
+  for (PlayerNumber player = 1; player <= N_PLAYERS; player++) {
+    // I cannot eat myself
+    if (player == eater) continue;
+    if (board.occupied(player).test(position)) rival = player;
   }
 
+  return rival;
+}
+
+static PlayerNumber eatenPlayerOnSafePosition(PlayerNumber eater,
+                                              const Board& board,
+                                              Position destPosition) {
   // If there are three pieces, there is no space
   // for the one that have just arrived
   // so one of the pieces that were there will be eaten.
-  if (piecesCounter == 3) {
-    return eaten;
+  if (board.count(destPosition) == 3) {
+    return rivalOnPosition(eater, board, destPosition);
   }
   // There is space for the piece so no other piece is sent to home
   else {
-    return nullptr;
+    return 0;
   }
 }
 
-Player* Game::eatenPlayer(const Player& eater, Position destPosition) {
+PlayerNumber Game::eatenPlayer(PlayerNumber eater,
+                               Position destPosition) const {
   if (!isEatingPosition(destPosition)) {
     // If the position is not dangerous, no further considerations
-    if (destPosition != getPlayerInitialPosition(eater.playerNumber)) {
-      return nullptr;
+    if (destPosition != getPlayerInitialPosition(eater)) {
+      return 0;
     }
 
     // It is possible to eat the adversary if there are three pieces on this
     // position. One of those will be from the enemy
-    if (barriers.find(destPosition) != barriers.end()) {
-      return eatenPlayerOnSafePosition(eater, players, destPosition);
-    } else {
-      return nullptr;
-    }
+    return eatenPlayerOnSafePosition(eater, board, destPosition);
   }
 
-  // Search for a player with a piece in the position
-  for (Player& player : players) {
-    // I cannot eat myself
-    if (player.playerNumber == eater.playerNumber) continue;
-
-    // If any of the pieces of this player is in the same position,
-    // I have eaten it
-    for (Position piece : player.pieces) {
-      if (piece == destPosition) return &player;
-    }
-  }
-
-  return nullptr;
+  // If any of the pieces of another player is in the same position,
+  // I have eaten it
+  return rivalOnPosition(eater, board, destPosition);
 }
 
 Position Game::movePiece(PlayerNumber playerNumber, Position piece,
                          unsigned int advance) {
-  Player& playerToMove = getPlayer(playerNumber);
-  return movePiece(playerToMove, piece, advance);
+  // The player knows whether the movement can be done
+  Player playerToMove = getPlayer(playerNumber);
+  Position destPosition =
+      playerToMove.movePiece(piece, advance, board.barriers());
+  takePiece(playerNumber, piece, destPosition);
+
+  return destPosition;
 };
 
-Position Game::movePiece(Player& player, Position piece, unsigned int advance) {
-  Position destPosition = player.movePiece(piece, advance, barriers);
-  updateInnerState(player, destPosition);
+std::optional<Position> Game::destination(PlayerNumber playerNumber,
+                                          Position piece,
+                                          unsigned int advance) const {
+  checkPlayer(playerNumber);
+  const GameState::Pieces& pieces = state.getPieces(playerNumber);
+  if (std::find(pieces.begin(), pieces.end(), piece) == pieces.end()) {
+    return std::nullopt;
+  }
+
+  return Player::destination(playerNumber, piece, advance, board,
+                             board.barriers());
+}
+
+std::optional<Position> Game::tryMovePiece(PlayerNumber playerNumber,
+                                           Position piece,
+                                           unsigned int advance) {
+  std::optional<Position> destPosition =
+      destination(playerNumber, piece, advance);
+  if (destPosition) takePiece(playerNumber, piece, *destPosition);
 
   return destPosition;
-};
+}
 
 void Game::takePiece(PlayerNumber playerNumber, Position piece, Position dest) {
-  Player& playerToMove = getPlayer(playerNumber);
-  takePiece(playerToMove, piece, dest);
+  makeMove({playerNumber, piece, dest});
 };
 
-void Game::takePiece(Player& player, Position piece, Position dest) {
-  auto itPiece = std::find(player.pieces.begin(), player.pieces.end(), piece);
-  if (itPiece == player.pieces.end()) {
+Game::MoveUndo Game::makeMove(const Move& move) {
+  checkPlayer(move.player);
+  GameState::Pieces& pieces = state.getPieces(move.player);
+  auto itPiece = std::find(pieces.begin(), pieces.end(), move.origin);
+  if (itPiece == pieces.end()) {
     throw Player::PieceNotFound("No piece to be moved");
   }
 
-  Position& pieceToMove = *itPiece;
-  pieceToMove = dest;
-  updateInnerState(player, dest);
-};
+  GameState::Square& lastTouched = state.lastTouched[move.player - 1];
+  double& punctuation = punctuations[move.player - 1];
+  MoveUndo undo{move, static_cast<std::uint8_t>(itPiece - pieces.begin()),
+                lastTouched, punctuation, hash};
+
+  // Only the player who moved changes its punctuation. Adding it again from
+  // the table instead of adding the difference keeps it exact.
+  *itPiece = move.dest;
+  hash += zobristPiece(move.player, move.dest) -
+          zobristPiece(move.player, move.origin) +
+          zobristLastTouched(move.player, move.dest) -
+          zobristLastTouched(move.player, lastTouched);
+  lastTouched = move.dest;
+  board.move(move.player, move.origin, move.dest);
+  punctuation = Player::piecesPunctuation(move.player, pieces);
+  assert(hash == zobristHash(state));
+
+  return undo;
+}
 
-void Game::pieceEaten(PlayerNumber playerNumber, Position eatenPiece) {
-  Player& playerToMove = getPlayer(playerNumber);
-  pieceEaten(playerToMove, eatenPiece);
-};
+void Game::unmakeMove(const MoveUndo& undo) {
+  const Move& move = undo.move;
+  state.getPieces(move.player)[undo.pieceIndex] = move.origin;
+  board.move(move.player, move.dest, move.origin);
+  state.lastTouched[move.player - 1] = undo.lastTouched;
+  punctuations[move.player - 1] = undo.punctuation;
+  hash = undo.hash;
 
-void Game::pieceEaten(Player& player, Position eatenPiece) {
-  player.pieceEaten(eatenPiece);
+  assert(hash == zobristHash(state));
+}
 
-  updateInnerState(player, HOME);
+void Game::pieceEaten(PlayerNumber playerNumber, Position eatenPiece) {
+  takePiece(playerNumber, eatenPiece, HOME);
 };
 
-void Game::updateInnerState(const Player& player, Position destPosition) {
-  barriers = loadBarriers(players);
-  setLastTouched(player, destPosition);
+static bool doubleDices(const DicePairRoll& dices) {
+  return dices.first == dices.second;
 }
 
-static bool doubleDices(const MovementsSequence& advances) {
-  return advances.size() == 2 && advances.front() == advances.back();
+static bool pieceCanBeMoved(Position piece, PlayerNumber playerNumber,
+                            unsigned int advance, const Game& currentGame) {
+  // The barriers are not taken into account
+  return Player::destination(playerNumber, piece, advance, currentGame.board,
+                             {}) != std::nullopt;
 }
 
-static bool doubleDices(const DicePairRoll& dices) {
-  return dices.first == dices.second;
+static bool doubleDices(const Advances& advances) {
+  return advances.size() == 2 && advances.front() == advances.back();
 }
 
-static std::set<Position> piecesOnBarrier(const Player& currentPlayer,
-                                          const std::set<Position>& barriers) {
-  std::set<Position> uniquePiecesOnBarrier;
-  for (Position piece : currentPlayer.pieces) {
-    bool isPieceOnABarrier = barriers.find(piece) != barriers.end();
-    if (isPieceOnABarrier) {
-      uniquePiecesOnBarrier.insert(piece);
+// Pieces a player can choose among
+using Candidates = StaticVector<Position, N_PIECES>;
+
+// Different positions of the pieces that pass the filter, sorted
+template <typename Filter>
+static Candidates differentPieces(const GameState::Pieces& pieces,
+                                  Filter filter) {
+  Candidates candidates;
+  for (Position piece : pieces) {
+    if (!filter(piece)) continue;
+    // Insertion sort, there are at most N_PIECES of them
+    std::size_t i = candidates.size();
+    while (i > 0 && candidates[i - 1] > piece) i--;
+    if (i > 0 && candidates[i - 1] == piece) continue;
+    candidates.push_back(piece);
+    for (std::size_t j = candidates.size() - 1; j > i; j--) {
+      candidates[j] = candidates[j - 1];
     }
+    candidates[i] = piece;
   }
-
-  return uniquePiecesOnBarrier;
+  return candidates;
 }
 
-static bool pieceCanBeMoved(Position piece, PlayerNumber playerNumber,
-                            unsigned int advance, Game currentGame) {
-  Player& playerToMove = currentGame.getPlayer(playerNumber);
-  try {
-    // Try to move the piece calling the Player object because its function is a
-    // bit lighter
-    playerToMove.movePiece(piece, advance);
-  } catch (Player::WrongMove e) {
-    // The current piece cannot be moved as much as wanted
-    return false;
+// Pieces the player can try to move with the next advance
+static Candidates piecesToMove(const Game& game, PlayerNumber player,
+                               const Advances& advances) {
+  unsigned int advance = advances.back();
+  const GameState::Pieces& pieces = game.state.getPieces(player);
+
+  // If the advance is 5 and I have pieces to take out from home, I cannot move
+  // any other piece
+  if (advance == OUT_OF_HOME && canTakeOutPieces(game.board, player)) {
+    Candidates home;
+    home.push_back(HOME);
+    return home;
   }
 
-  // The piece was moved successfully
-  return true;
-}
+  // With double dices, the barriers that can be broken must be broken
+  if (doubleDices(advances)) {
+    const SquareMask& barriers = game.board.barriers();
+    auto isOnBarrier = [&](Position piece) { return barriers.test(piece); };
+    Candidates breakable = differentPieces(pieces, [&](Position piece) {
+      return isOnBarrier(piece) &&
+             pieceCanBeMoved(piece, player, advance, game);
+    });
+    if (!breakable.empty()) return breakable;
+
+    // There is no barrier that can be broken, but the pieces on a barrier
+    // are still the only candidates
+    Candidates barrierPieces = differentPieces(pieces, isOnBarrier);
+    if (!barrierPieces.empty()) return barrierPieces;
+  }
 
-static void filterPiecesThatCanBeMoved(std::set<Position>& pieces,
-                                       PlayerNumber playerNumber,
-                                       unsigned int advance,
-                                       const Game& currentGame) {
-  std::erase_if(pieces, [&](Position piece) {
-    return !pieceCanBeMoved(piece, playerNumber, advance, currentGame);
-  });
+  // If I have not mandatory pieces to move, all the pieces are candidates to be
+  // moved
+  return differentPieces(pieces, [](Position) { return true; });
 }
 
-std::vector<Game::Turn> Game::allPossibleStatesFromSequence(
-    const Player& currentPlayer, const MovementsSequence& advances) const {
-  // Returns all the states I can access with this sequence of movements
-  // The order of the sequence is fixed
-
-  std::vector<Game::Turn> states;
+// Generates the turns depth first. The movements of the turn being built are
+// kept on a stack, and every completed turn is written to the buffer, so
+// nothing is allocated once the buffer is big enough.
+template <typename Turns>
+class TurnGenerator {
+ public:
+  // Turns that get to a state already in uniqueStates are not written, if
+  // it is given
+  TurnGenerator(PlayerNumber player, Turns& turns,
+                StateSet* uniqueStates = nullptr)
+      : player(player), turns(turns), uniqueStates(uniqueStates) {}
+
+  // Performs the next advance with every piece that can do it and then the
+  // rest of the advances. Returns whether any piece could be moved.
+  bool generate(const Game& game, Advances advances);
+
+  // Number of turns written to the buffer
+  std::size_t size() const { return nTurns; }
+  // Number of turns discarded because their state was repeated
+  std::size_t repeated() const { return nRepeated; }
+
+ private:
+  bool generateWithBoost(const Game& game, Advances advances,
+                         unsigned int boost);
+  void addTurn(const Game& game);
+
+  PlayerNumber player;
+  Play moves;
+  Turns& turns;
+  std::size_t nTurns{0};
+
+  StateSet* uniqueStates;
+  std::size_t nRepeated{0};
+};
 
-  // Take the advance I will try to perform
-  unsigned int advance = advances.front();
+template <typename Turns>
+void TurnGenerator<Turns>::addTurn(const Game& game) {
+  // The canonical key is exact, so two turns are only merged if they get to
+  // the same state. The hash could merge different ones on a collision.
+  if (uniqueStates && !uniqueStates->insert(canonicalKey(game.getState()))) {
+    nRepeated++;
+    return;
+  }
 
-  std::set<Position> piecesToMove;
+  // Reuse the turns already in the buffer
+  if (nTurns == turns.size()) turns.emplace_back();
+  Game::Turn& turn = turns[nTurns++];
+  turn.finalState = game.getState();
+  turn.movements = moves;
+}
 
-  // If the advance is 5 and I have pieces to take out from home, I cannot move
-  // any other piece
-  if (advance == OUT_OF_HOME && canTakeOutPieces(currentPlayer)) {
-    piecesToMove = {HOME};
-  }
-  // Check if I got doubles dices
-  else if (doubleDices(advances)) {
-    // Ask all the pieces that are on a barrier
-    std::set<Position> barrierPieces = piecesOnBarrier(currentPlayer, barriers);
-    // all of them are candidates to be moved.
-    piecesToMove = barrierPieces;
-    // Remove the barriers that cannot be broken
-    filterPiecesThatCanBeMoved(piecesToMove, currentPlayer.playerNumber,
-                               advance, *this);
-
-    // There is no barrier that can be broken,
-    // fill piecesToMove with the pieces that are not in barriers
-    if (piecesToMove.empty()) {
-      for (Position piece : currentPlayer.pieces) {
-        if (barrierPieces.find(piece) != barrierPieces.end())
-          piecesToMove.insert(piece);
-      }
-    }
+template <typename Turns>
+bool TurnGenerator<Turns>::generateWithBoost(const Game& game,
+                                             Advances advances,
+                                             unsigned int boost) {
+  if (SearchStats* stats = getSearchStats(game)) {
+    SearchStats::add(stats->boostRecursions);
   }
 
-  // If I have not mandatory pieces to move, all the pieces are candidates to be
-  // moved
-  if (piecesToMove.empty()) {
-    const auto& playerPieces = currentPlayer.pieces;
-    piecesToMove.insert(playerPieces.begin(), playerPieces.end());
-  }
+  advances.push_back(boost);
+  return generate(game, advances);
+}
 
-  for (Position piece : piecesToMove) {
-    // Create a new game to not modify the current one
-    Game newGame = *this;
-    // Make the current player to move the current amount
-    Player& playerToMove = newGame.getPlayer(currentPlayer.playerNumber);
-    Move move{currentPlayer.playerNumber, piece};
-    try {
-      // Move the piece calling the Game object to get the barriers updated
-      move.dest = newGame.movePiece(playerToMove, piece, advance);
-    } catch (Player::WrongMove e) {
-      // The current piece cannot be moved as much as wanted,
-      // so no new state can be created
-      continue;
+template <typename Turns>
+bool TurnGenerator<Turns>::generate(const Game& game, Advances advances) {
+  const Candidates candidates = piecesToMove(game, player, advances);
+  // Take the advance I will try to perform
+  const unsigned int advance = advances.back();
+  advances.pop_back();
+
+  bool anyMoved = false;
+  for (Position piece : candidates) {
+    // Create a new game to not modify the current one. Copying it is cheaper
+    // than making and unmaking the move, see BM_ChildGame.
+    Game newGame = game;
+    std::optional<Position> dest = newGame.tryMovePiece(player, piece, advance);
+    // The current piece cannot be moved as much as wanted,
+    // so no new state can be created
+    if (!dest) continue;
+    anyMoved = true;
+
+    const std::size_t previousMoves = moves.size();
+    moves.push_back({player, piece, *dest});
+
+    // I ate someone, add the movement of taking its piece back home
+    PlayerNumber eatenPlayer{newGame.eatenPlayer(player, *dest)};
+    if (eatenPlayer != 0) {
+      newGame.pieceEaten(eatenPlayer, *dest);
+      moves.push_back({eatenPlayer, *dest, HOME});
     }
 
-    // Check I got to goal, which lets me advance 10 positions
-    bool gotToGoal{move.dest == GOAL};
+    // Getting to goal or eating lets me advance some more positions.
+    // If the boost cannot be performed, the rest of the dices must be
+    // executed anyway.
+    bool continued =
+        (*dest == GOAL &&
+         generateWithBoost(newGame, advances, EXTRA_MOVEMENT_ON_GOAL)) ||
+        (eatenPlayer != 0 &&
+         generateWithBoost(newGame, advances, EXTRA_MOVEMENT_ON_KILL)) ||
+        (!advances.empty() && generate(newGame, advances));
 
-    // Movements derived from the current movement
-    std::vector<Move> decisionMovements{move};
+    // There are no more pieces to move, so the turn ends here
+    if (!continued) addTurn(newGame);
 
-    // Check I ate one rival piece
-    Player* eatenPlayer{newGame.eatenPlayer(playerToMove, move.dest)};
-    bool haveEaten{eatenPlayer != nullptr};
-    // I ate someone, add the movement of taking its piece back home
-    if (haveEaten) {
-      // Execute the movement to home
-      newGame.pieceEaten(*eatenPlayer, move.dest);
-      // Store the movement
-      Move killingMove{eatenPlayer->playerNumber, move.dest, HOME};
-      decisionMovements.push_back(killingMove);
-    }
+    moves.resize(previousMoves);
+  }
 
-    // The movement can be performed on the current piece
-    // Ask for all the movements that I can do now
-    std::vector<Turn> nextStates = ulteriorMovements(
-        playerToMove, advances, newGame, gotToGoal, haveEaten);
-
-    if (!nextStates.empty()) {
-      for (const Turn& nextState : nextStates) {
-        const Play& nextMovements = nextState.movements;
-        Turn turn{nextState.finalState, decisionMovements};
-        turn.movements.insert(turn.movements.end(),
-                              std::make_move_iterator(nextMovements.begin()),
-                              std::make_move_iterator(nextMovements.end()));
-        states.push_back(turn);
-      }
-    } else {
-      // There are no more pieces to move,
-      // so I add to the vector the current movement
-      Turn turn{{newGame.players, newGame.lastTouched}, decisionMovements};
-      states.push_back(turn);
-    }
+  return anyMoved;
+}
+
+std::vector<Game::Turn> Game::allPossibleStatesFromSequence(
+    PlayerNumber currentPlayer, const MovementsSequence& sequence) const {
+  // Returns all the states I can access with this sequence of movements
+  // The order of the sequence is fixed
+  Advances advances;
+  for (std::size_t i = sequence.size(); i-- > 0;) {
+    advances.push_back(sequence[i]);
   }
 
+  std::vector<Turn> states;
+  if (advances.empty()) return states;
+
+  TurnGenerator generator(currentPlayer, states);
+  generator.generate(*this, advances);
+  states.resize(generator.size());
   return states;
 }
 
@@ -470,7 +512,7 @@ bool operator==(const Move& m1, const Move& m2) {
   return m1.player == m2.player && m1.origin == m2.origin && m1.dest == m2.dest;
 }
 
-static bool hasMovedABarrier(const std::set<Position>& barriers,
+static bool hasMovedABarrier(const SquareMask& barriers,
                              const Game::Turn& turn) {
   // If I got a double dice I must break a barrier.
   // This means that if I moved one element of the barrier,
@@ -481,7 +523,7 @@ static bool hasMovedABarrier(const std::set<Position>& barriers,
   const Play& movements = turn.movements;
   const Move& firstMove = movements.front();
   Position firstMovedPiece = firstMove.origin;
-  bool brokeBarrier{barriers.find(firstMovedPiece) != barriers.end()};
+  bool brokeBarrier{barriers.test(firstMovedPiece)};
   if (!brokeBarrier) return false;
 
   for (auto itMovement = std::next(movements.begin());
@@ -503,212 +545,662 @@ std::vector<Game::Turn> Game::tripleDouble(PlayerNumber playerNumber) const {
     Game newGame = *this;
     newGame.pieceEaten(playerNumber, lastTouchedPosition);
     Move goHomeMove{playerNumber, lastTouchedPosition, HOME};
-    return {{newGame.getState(), Play({goHomeMove})}};
+    return {{newGame.getState(), Play{goHomeMove}}};
   } else {
     // If the piece cannot go back home I cannot make movement anyway
     // So leave the table as it is and go to the next player
-    return {{getState(), Play({})}};
+    return {{getState(), Play{}}};
   }
 };
 
-static bool operator<(const Game::Turn::FinalState& t1,
-                      const Game::Turn::FinalState& t2) {
-  // Check the pieces
-  for (unsigned int playerIndex = 0; playerIndex < t1.players.size();
-       playerIndex++) {
-    const Player::Pieces& pieces1 = t1.players[playerIndex].pieces;
-    Player::Pieces sortedPieces1;
-    std::partial_sort_copy(pieces1.begin(), pieces1.end(),
-                           sortedPieces1.begin(), sortedPieces1.end());
-
-    const Player::Pieces& pieces2 = t2.players[playerIndex].pieces;
-    Player::Pieces sortedPieces2;
-    std::partial_sort_copy(pieces2.begin(), pieces2.end(),
-                           sortedPieces2.begin(), sortedPieces2.end());
-    for (unsigned int pieceIndex = 0; pieceIndex < sortedPieces2.size();
-         pieceIndex++) {
-      if (sortedPieces1[pieceIndex] < sortedPieces2[pieceIndex]) {
-        return true;
-      } else if (sortedPieces1[pieceIndex] > sortedPieces2[pieceIndex]) {
-        return false;
-      }
-    }
+template <typename Turns>
+void Game::generateTurns(PlayerNumber player, const DicePairRoll& dices,
+                         unsigned int rollsInARow, Turns& turns) const {
+  // If this is the third double, exit the function and take the last touched
+  // piece to HOME
+  if (rollsInARow == 3 && doubleDices(dices)) {
+    std::vector<Turn> tripleDoubleTurns = tripleDouble(player);
+    turns.assign(tripleDoubleTurns.begin(), tripleDoubleTurns.end());
+    return;
   }
 
-  // Check last touched
-  for (unsigned int playerIndex = 0; playerIndex < t1.lastTouched.size();
-       playerIndex++) {
-    if (t1.lastTouched[playerIndex] < t2.lastTouched[playerIndex]) {
-      return true;
-    } else if (t1.lastTouched[playerIndex] > t2.lastTouched[playerIndex]) {
-      return false;
-    }
-  }
-  return false;
-}
+  // Skip the turns which would leave me on the same state as a previous one.
+  // Every thread keeps its set, so its memory is reused by every node.
+  static thread_local StateSet uniqueStates;
+  uniqueStates.clear();
 
-static std::vector<Game::Turn> uniqueStates(
-    const std::vector<Game::Turn>& states) {
-  std::set<Game::Turn::FinalState> seenStates;
+  // From de dices get the sequences of movements
+  TurnGenerator generator(player, turns, &uniqueStates);
+  for (const Advances& advances : movementsSequences(board, player, dices)) {
+    generator.generate(*this, advances);
+  }
+  turns.resize(generator.size());
 
-  std::vector<Game::Turn> vtUniqueStates;
-  vtUniqueStates.reserve(states.size());
+  SearchStats* stats = getSearchStats(*this);
+  if (stats) SearchStats::add(stats->duplicatedStates, generator.repeated());
 
-  for (const Game::Turn& state : states) {
-    if (seenStates.find(state.finalState) == seenStates.end()) {
-      vtUniqueStates.push_back(state);
-      seenStates.insert(state.finalState);
+  // If I got double dices, reject the combinations
+  // of movements that have moved a barrier.
+  // Barriers must be broken, not moved
+  if (doubleDices(dices)) {
+    auto movedABarrier = [&](const Turn& turn) {
+      return hasMovedABarrier(board.barriers(), turn);
+    };
+    std::size_t movedBarriers =
+        std::count_if(turns.begin(), turns.end(), movedABarrier);
+    // If there are no movements to be done, allow moving the barrier
+    if (movedBarriers < turns.size()) {
+      if (stats) SearchStats::add(stats->movedBarriers, movedBarriers);
+      std::erase_if(turns, movedABarrier);
     }
   }
-
-  return vtUniqueStates;
 }
 
+template void Game::generateTurns(PlayerNumber, const DicePairRoll&,
+                                  unsigned int, std::vector<Turn>&) const;
+template void Game::generateTurns(PlayerNumber, const DicePairRoll&,
+                                  unsigned int,
+                                  std::pmr::vector<Turn>&) const;
+
 std::vector<Game::Turn> Game::allPossibleStates(
     const Player& currentPlayer, const DicePairRoll& dices,
     unsigned int rollsInARow /* = 1*/) const {
-  // If this is the third double, exit the function and take the last touched
-  // piece to HOME
-  if (rollsInARow == 3 && doubleDices(dices)) {
-    return tripleDouble(currentPlayer.playerNumber);
-  }
-
-  // From de dices get the sequences of movements
-  auto possibleMovements = movementsSequences(currentPlayer, dices);
   std::vector<Turn> states;
-  for (const auto& sequence : possibleMovements) {
-    std::vector<Turn> statesForSequence =
-        allPossibleStatesFromSequence(currentPlayer, sequence);
-    states.insert(states.end(), statesForSequence.begin(),
-                  statesForSequence.end());
+  generateTurns(currentPlayer.playerNumber, dices, rollsInARow, states);
+  return states;
+}
+
+// Table of the solved endgames, if any
+static const EndgameTable* getEndgameTable(const Game& game) {
+  const SearchContext* context = game.getSearchContext();
+  return context ? context->endgameTable : nullptr;
+}
+
+// Punctuation of the player on the leaves: the exact one if its endgame is
+// solved
+static double leafPunctuation(const Game& game, PlayerNumber player) {
+  const EndgameTable* endgameTable = getEndgameTable(game);
+  const GameState::Pieces& pieces = game.getState().getPieces(player);
+  if (endgameTable && EndgameTable::covers(pieces)) {
+    return endgameTable->at(pieces).punctuation;
   }
-  // Remove the states which would leave me on the same state
-  states = uniqueStates(states);
+  return game.getPunctuation(player);
+}
 
-  // If I got double dices, reject the combinations
-  // of movements that have moved a barrier.
-  // Barriers must be broken, not moved
-  if (dices.first == dices.second) {
-    std::vector<Turn> filteredStates;
-    filteredStates.reserve(states.size());
+// Highest punctuation the leaves can give to the player after it moves its
+// pieces forward
+static double maxReachableLeafPunctuation(const Game& game,
+                                          PlayerNumber player) {
+  const EndgameTable* endgameTable = getEndgameTable(game);
+  const GameState::Pieces& pieces = game.getState().getPieces(player);
+  double highest = Player::maxReachablePunctuation(player, pieces);
+  if (!endgameTable) return highest;
+
+  if (EndgameTable::covers(pieces)) {
+    return endgameTable->at(pieces).maxReachablePunctuation;
+  }
+  // The pieces can get to any endgame of the table
+  return std::max(highest, endgameTable->maxPunctuation());
+}
 
-    for (const Turn& turn : states) {
-      if (!hasMovedABarrier(barriers, turn)) {
-        filteredStates.push_back(turn);
-      }
-    }
-    // If there are no movements to be done, allow moving the barrier
-    if (!filteredStates.empty()) states = filteredStates;
+// Both players have all their pieces in the hallway, so their races are
+// solved and do not depend on each other
+static bool isSolvedEndgame(const Game& game) {
+  if (!getEndgameTable(game)) return false;
+  for (PlayerNumber player = 1; player <= N_PLAYERS; player++) {
+    if (!EndgameTable::covers(game.getState().getPieces(player))) return false;
   }
+  return true;
+}
 
-  return states;
+// Score of a solved endgame from the perspective of the current player.
+// The chances of winning the race are mapped onto the scores the leaves give
+// to the endgames of the table: a sure win is the widest lead between two of
+// them and an even race is a tie.
+static double solvedEndgameScore(const Game& game, PlayerNumber currentPlayer,
+                                 PlayerNumber nextPlayer,
+                                 unsigned int nextRollsInARow) {
+  const EndgameTable* endgameTable = getEndgameTable(game);
+  const GameState& state = game.getState();
+  double nextWins = endgameTable->winProbability(
+      state.getPieces(nextPlayer), nextRollsInARow,
+      state.getPieces(nextPlayerNumber(nextPlayer)));
+  double currentWins = currentPlayer == nextPlayer ? nextWins : 1 - nextWins;
+  return endgameTable->maxPunctuation() * (1 - 2 * currentWins);
 }
 
-double Game::nonRecursiveEvaluateState(const Player& currentPlayer) const {
+double Game::nonRecursiveEvaluateState(PlayerNumber currentPlayer) const {
   double value{0.0};
-  for (const Player& player : players) {
-    double playerValue = player.punctuation();
-    if (player.playerNumber == currentPlayer.playerNumber) playerValue *= -1;
+  for (PlayerNumber player = 1; player <= N_PLAYERS; player++) {
+    double playerValue = leafPunctuation(*this, player);
+    if (player == currentPlayer) playerValue *= -1;
     value -= playerValue;
   }
 
   return value;
 }
 
-double Game::evaluateState(const Player& currentPlayer,
-                           const Player& nextPlayer, unsigned int depth,
-                           unsigned int rollsInARow) const {
+// Table where the search results are cached, if any
+static TranspositionTable* getTranspositionTable(const Game& game) {
+  const SearchContext* context = game.getSearchContext();
+  return context ? context->transpositionTable : nullptr;
+}
+
+// Whether the children of the node are split between the workers
+static bool searchInParallel(const Game& game, unsigned int depth,
+                             std::size_t count) {
+  const SearchContext* context = game.getSearchContext();
+  return context && context->threadPool &&
+         depth >= context->minParallelDepth && count > 1;
+}
+
+// Calls task(i) for every i in [0, count).
+// Splits the calls between the workers if the node is deep enough.
+static void forEachChild(const Game& game, unsigned int depth,
+                         std::size_t count,
+                         const std::function<void(std::size_t)>& task) {
+  if (searchInParallel(game, depth, count)) {
+    game.getSearchContext()->threadPool->parallelFor(count, task);
+  } else {
+    for (std::size_t i = 0; i < count; i++) task(i);
+  }
+}
+
+static bool isPruningEnabled(const Game& game) {
+  const SearchContext* context = game.getSearchContext();
+  return !context || context->pruning;
+}
+
+// No score can be out of [-maxScore, maxScore]: at best a player has won and
+// the other one has all the pieces at home
+static double maxScore() {
+  static const double score = [] {
+    constexpr GameState::Pieces allAtHome{HOME, HOME, HOME, HOME};
+    double maxPunctuation{0.0};
+    for (PlayerNumber player = 1; player <= N_PLAYERS; player++) {
+      maxPunctuation = std::max(maxPunctuation,
+                                Player::piecesPunctuation(player, allAtHome));
+    }
+    return maxPunctuation - Player::WON_PUNCTUATION;
+  }();
+  return score;
+}
+
+// Widening of the windows so the rounding of the scores never prunes a branch
+// that should have been searched
+static constexpr double SCORE_MARGIN = 1e-6;
+
+// Scores a roll of a chance node can get
+struct ScoreRange {
+  double lowest;
+  double highest;
+};
+
+// Scores the rolls can get from the perspective of the current player
+static ScoreRange rollScoreRange(const Game& game, PlayerNumber currentPlayer,
+                                 PlayerNumber nextPlayer, unsigned int depth,
+                                 unsigned int nextRollsInARow) {
+  // Deeper searches can get to any score. The third double sends a piece of
+  // the next player back home.
+  if (depth > 1 || nextRollsInARow >= 3) return {-maxScore(), maxScore()};
+
+  // The next player moves once before the state is evaluated. Its pieces only
+  // move forward and the pieces of the other player can only be sent home,
+  // so its best score cannot be higher than this
+  PlayerNumber otherPlayer = nextPlayerNumber(nextPlayer);
+  double highestForNext = maxReachableLeafPunctuation(game, nextPlayer) -
+                          leafPunctuation(game, otherPlayer);
+  // The move can end in a solved endgame, which is never scored higher than
+  // the widest lead of the table
+  const EndgameTable* endgameTable = getEndgameTable(game);
+  if (endgameTable &&
+      EndgameTable::covers(game.getState().getPieces(otherPlayer))) {
+    highestForNext = std::max(highestForNext, endgameTable->maxPunctuation());
+  }
+
+  if (currentPlayer == nextPlayer) return {-maxScore(), highestForNext};
+  return {-highestForNext, maxScore()};
+}
+
+// Star1 pruning of a chance node.
+// Knowing the weighted score of the rolls already seen and the probability of
+// the ones not seen yet, returns the scores of the roll that can leave the
+// score of the node inside its window. Out of it, the unseen rolls cannot
+// bring it back whatever their score is.
+static SearchWindow rollWindow(const SearchWindow& window,
+                               const ScoreRange& range, double seenScore,
+                               double probability, double unseenProbability) {
+  double unseenLowest = unseenProbability * range.lowest;
+  double unseenHighest = unseenProbability * range.highest;
+  return {
+      (window.alpha - seenScore - unseenHighest) / probability - SCORE_MARGIN,
+      (window.beta - seenScore - unseenLowest) / probability + SCORE_MARGIN};
+}
+
+double Game::evaluateState(PlayerNumber currentPlayer,
+                           PlayerNumber nextPlayer, unsigned int depth,
+                           unsigned int rollsInARow,
+                           const SearchWindow& window /*= {}*/) const {
   // Non recursive case
+  SearchStats* stats = getSearchStats(*this);
+  // If turn has changed, the rolls ina row reset to 1
+  bool isSamePlayer = (currentPlayer == nextPlayer);
+  unsigned int nextRollsInARow = isSamePlayer ? rollsInARow + 1 : 1;
+
+  // A solved endgame is already scored with the exact chances of winning
+  if (isSolvedEndgame(*this)) {
+    if (stats) SearchStats::add(stats->leafEvaluations);
+    return solvedEndgameScore(*this, currentPlayer, nextPlayer,
+                              nextRollsInARow);
+  }
   if (depth == 0) {
+    if (stats) SearchStats::add(stats->leafEvaluations);
     return nonRecursiveEvaluateState(currentPlayer);
   }
 
+  // Check whether this state has already been evaluated
+  TranspositionTable* transpositionTable = getTranspositionTable(*this);
+  TranspositionTable::Key key;
+  if (transpositionTable) {
+    key = TranspositionTable::chanceKey(getState(), currentPlayer, nextPlayer,
+                                        depth, rollsInARow);
+    auto cached = transpositionTable->probe(key, window);
+    if (stats) {
+      SearchStats::add(stats->cacheProbes);
+      if (cached) SearchStats::add(stats->cacheHits);
+    }
+    if (cached) return cached->score;
+  }
+
+  // With each dice roll, which is the best movement the next player can make.
+  // The scores are stored from my perspective.
+  constexpr UnorderedRollsProb rolls{getUnorderedRollsProb()};
+  std::array<double, rolls.size()> rollScores{};
+  std::array<SearchWindow, rolls.size()> rollWindows{};
+  auto evaluateRoll = [&](std::size_t i) {
+    // TODO: This calculation considers everything that is good for my
+    // opponent is bad for me and vice versa. If there were more than two
+    // players that would not be the case
+    const SearchWindow& rollWindow = rollWindows[i];
+    double score =
+        searchBestPlay(nextPlayer, rolls[i].first, nextRollsInARow, depth - 1,
+                       isSamePlayer ? rollWindow : rollWindow.flipped())
+            .score;
+    rollScores[i] = isSamePlayer ? score : -score;
+  };
+
+  const bool pruning = isPruningEnabled(*this);
+  const bool inParallel = searchInParallel(*this, depth, rolls.size());
+  ScoreRange range{-maxScore(), maxScore()};
+  if (pruning) {
+    range = rollScoreRange(*this, currentPlayer, nextPlayer, depth,
+                           nextRollsInARow);
+  }
+
+  if (inParallel) {
+    // The rolls are evaluated at the same time, so none of them knows the
+    // score of the rest
+    if (pruning) {
+      for (std::size_t i = 0; i < rolls.size(); i++) {
+        double probability = rolls[i].second;
+        rollWindows[i] =
+            rollWindow(window, range, 0, probability, 1 - probability);
+      }
+    }
+    forEachChild(*this, depth, rolls.size(), evaluateRoll);
+  }
+
   // Make a weighted average of the punctuations after the next movement has
-  // been made
+  // been made. Always add them in the same order so the result does not
+  // depend on the threads nor on the pruning.
   double punctuation = 0;
-  // Iterate all the possible dices rolls for the next turn
-  for (auto [roll, probability] : getUnorderedRollsProb()) {
-    // If turn has changed, the rolls ina row reset to 1
-    bool isSamePlayer = (currentPlayer.playerNumber == nextPlayer.playerNumber);
-    unsigned int nextRollsInARow = isSamePlayer ? rollsInARow + 1 : 1;
-
-    // With this dices which is the best movement the next player can make
-    ScoredPlay scoredBestPlay =
-        bestPlay(nextPlayer.playerNumber, roll, nextRollsInARow, depth - 1);
-
-    // I know what the next player is going to make, now I have to estimate a
-    // punctuation from pmy perspective of this action
-    if (isSamePlayer) {
-      punctuation += scoredBestPlay.score * probability;
-    } else {
-      // TODO: This calculation considers everything that is good for my
-      // opponent is bad for me and vice versa. If there were more than two
-      // players that would not be the case
-      punctuation -= scoredBestPlay.score * probability;
+  double unseenProbability = 1;
+  auto bound = TranspositionTable::Bound::EXACT;
+  for (std::size_t i = 0; i < rolls.size(); i++) {
+    double probability = rolls[i].second;
+    unseenProbability = std::max(unseenProbability - probability, 0.0);
+
+    if (!inParallel) {
+      if (pruning) {
+        rollWindows[i] = rollWindow(window, range, punctuation, probability,
+                                    unseenProbability);
+      }
+      evaluateRoll(i);
+    }
+
+    // The score of the node is out of its window, no matter the rest of rolls
+    if (rollScores[i] <= rollWindows[i].alpha) {
+      punctuation = window.alpha;
+      bound = TranspositionTable::Bound::UPPER;
+      break;
+    }
+    if (rollScores[i] >= rollWindows[i].beta) {
+      punctuation = window.beta;
+      bound = TranspositionTable::Bound::LOWER;
+      break;
     }
+
+    punctuation += rollScores[i] * probability;
   }
 
-  return punctuation;
+  if (transpositionTable) {
+    transpositionTable->store(key, depth, {{}, punctuation}, bound);
+  }
 
-  throw std::logic_error("Not implemented error");
+  return punctuation;
 }
 
-static double evaluateStateInDepth(Game::Turn::FinalState state,
-                                   const Player& currentPlayer,
-                                   const Player& nextPlayer, unsigned int depth,
-                                   unsigned int rollsInARow) {
-  Game newGame(state);
-  double evaluation =
-      newGame.evaluateState(currentPlayer, nextPlayer, depth, rollsInARow);
+// Evaluates the state the turn gets to. The turn is made on the game and
+// reverted afterwards, so the search does not build a game for every child.
+static double evaluateTurnInDepth(Game& game, const Game::Turn& turn,
+                                  PlayerNumber currentPlayer,
+                                  PlayerNumber nextPlayer, unsigned int depth,
+                                  unsigned int rollsInARow,
+                                  const SearchWindow& window) {
+  // Not initialized, only the first moves of the turn are written
+  std::array<Game::MoveUndo, MAX_TURN_MOVES> undos;
+  const std::size_t nMoves = turn.movements.size();
+  for (std::size_t i = 0; i < nMoves; i++) {
+    undos[i] = game.makeMove(turn.movements[i]);
+  }
+  assert(game.getState() == turn.finalState);
+
+  double evaluation = game.evaluateState(currentPlayer, nextPlayer, depth,
+                                         rollsInARow, window);
+
+  for (std::size_t i = nMoves; i-- > 0;) game.unmakeMove(undos[i]);
   return evaluation;
 }
 
+// Indices of the turns, the ones that look better for the player first.
+// The score of the previous iteration of an iterative deepening is the best
+// estimation, if there is none it uses the evaluation of the state.
+// The indices are allocated from the arena of the thread.
+static std::pmr::vector<std::size_t> orderTurns(
+    const Game& game, const std::pmr::vector<Game::Turn>& turns,
+    PlayerNumber player, PlayerNumber nextPlayer, unsigned int depth,
+    unsigned int rollsInARow) {
+  TranspositionTable* transpositionTable = getTranspositionTable(game);
+  std::pmr::vector<double> estimations(turns.size(), &Arena::local());
+  for (std::size_t i = 0; i < turns.size(); i++) {
+    const GameState& state = turns[i].finalState;
+    if (transpositionTable && depth > 0) {
+      auto key = TranspositionTable::chanceKey(state, player, nextPlayer,
+                                               depth - 1, rollsInARow);
+      if (auto previous = transpositionTable->probe(key)) {
+        estimations[i] = previous->score;
+        continue;
+      }
+    }
+
+    estimations[i] = 0;
+    for (PlayerNumber other = 1; other <= N_PLAYERS; other++) {
+      double punctuation =
+          Player::piecesPunctuation(other, state.getPieces(other));
+      estimations[i] += (other == player) ? punctuation : -punctuation;
+    }
+  }
+
+  std::pmr::vector<std::size_t> order(turns.size(), &Arena::local());
+  for (std::size_t i = 0; i < order.size(); i++) order[i] = i;
+  std::stable_sort(order.begin(), order.end(), [&](auto lhs, auto rhs) {
+    return estimations[lhs] < estimations[rhs];
+  });
+
+  return order;
+}
+
+// The plays of the caches are seen from the side of player 1, see
+// TranspositionTable::isMirrored. Mirroring twice gives the same play, so
+// this takes the plays of the player into the caches and back.
+static ScoredPlay switchCacheSide(const ScoredPlay& scoredPlay,
+                                  PlayerNumber player) {
+  if (!TranspositionTable::isMirrored(player)) return scoredPlay;
+  return {mirrorPlay(scoredPlay.play), scoredPlay.score};
+}
+
+// Order of the turns that tie: their final states seen from the side of
+// player 1. A position and its mirror generate their turns in different
+// orders, so this is what makes both choose the same turn and store the same
+// play in the caches they share.
+static std::uint64_t tieBreakKey(const Game::Turn& turn, PlayerNumber player) {
+  if (TranspositionTable::isMirrored(player)) {
+    return canonicalKey(mirrorState(turn.finalState));
+  }
+  return canonicalKey(turn.finalState);
+}
+
 ScoredPlay Game::bestPlay(PlayerNumber playerId, DicePairRoll dices,
                           unsigned int rollsInARow /*= 1*/,
-                          unsigned int depth /*= 1*/) const {
-  const Player& player{getPlayer(playerId)};
-  const Player& nextPlayer{doubleDices(dices) ? player
-                                              : getNextPlayer(playerId)};
+                          unsigned int depth /*= 1*/,
+                          const SearchWindow& window /*= {}*/) const {
+  // Check whether this decision has already been taken offline. Only the
+  // searches of the depth of the book are served, and only at their root:
+  // the scores of the book are not bounded as the ones of the inner nodes
+  // and they are not stored in the transposition table as if they had been
+  // searched.
+  const OpeningBook* openingBook =
+      searchContext ? searchContext->openingBook : nullptr;
+  if (openingBook && depth == openingBook->depth()) {
+    auto bookKey = OpeningBook::key(getState(), playerId, dices, rollsInARow);
+    if (auto known = openingBook->probe(bookKey)) {
+      if (SearchStats* stats = getSearchStats(*this)) {
+        SearchStats::add(stats->bookHits);
+      }
+      return switchCacheSide(*known, playerId);
+    }
+  }
+
+  return searchBestPlay(playerId, dices, rollsInARow, depth, window);
+}
+
+ScoredPlay Game::searchBestPlay(PlayerNumber playerId, DicePairRoll dices,
+                                unsigned int rollsInARow, unsigned int depth,
+                                const SearchWindow& window) const {
+  // A double rolls again, unless it is the third one, which ends the turn
+  const bool rollsAgain = doubleDices(dices) && rollsInARow < 3;
+  const PlayerNumber nextPlayer{rollsAgain ? playerId
+                                           : nextPlayerNumber(playerId)};
+
+  // Stop here if there is no time left
+  if (searchContext && searchContext->budget) {
+    searchContext->budget->spendNode();
+  }
+  SearchStats* stats = getSearchStats(*this);
+  if (stats) {
+    SearchStats::add(
+        stats->nodesPerDepth[std::min(depth, SearchStats::MAX_DEPTH)]);
+  }
+
+  // Check whether this decision has already been taken by a previous search
+  TranspositionTable* transpositionTable = getTranspositionTable(*this);
+  TranspositionTable::Key key;
+  if (transpositionTable) {
+    key = TranspositionTable::decisionKey(getState(), playerId, dices, depth,
+                                          rollsInARow);
+    auto cached = transpositionTable->probe(key, window);
+    if (stats) {
+      SearchStats::add(stats->cacheProbes);
+      if (cached) SearchStats::add(stats->cacheHits);
+    }
+    if (cached) return switchCacheSide(*cached, playerId);
+  }
+
+  // The containers of the node are given back to the arena when it returns
+  Arena& arena = Arena::local();
+  Arena::Scope arenaScope(arena);
 
   ScoredPlay bestPlay = {{}, INFINITY};
   // Get all the possible states I can get with this dice roll
-  std::vector<Turn> turns{allPossibleStates(player, dices)};
-  for (const Turn& turn : turns) {
-    // Get the final state of the player that has made a movement
-    const Player& finalPlayerSate =
-        ::getPlayer(turn.finalState.players, player.playerNumber);
-
-    // If I find a turn for which I win, stop searching
-    if (finalPlayerSate.hasWon()) {
-      return {turn.movements, finalPlayerSate.punctuation()};
+  std::pmr::vector<Turn> turns(&arena);
+  {
+    SearchStats::Timer timer(stats ? &stats->generationTime : nullptr);
+    generateTurns(playerId, dices, rollsInARow, turns);
+  }
+  if (stats) SearchStats::add(stats->generatedTurns, turns.size());
+
+  // If I find a turn for which I win, there is no need to search
+  auto winningTurn = turns.end();
+  std::uint64_t winningKey = UINT64_MAX;
+  for (auto turn = turns.begin(); turn != turns.end(); turn++) {
+    if (!hasWon(turn->finalState, playerId)) continue;
+    const std::uint64_t turnKey = tieBreakKey(*turn, playerId);
+    if (turnKey < winningKey) {
+      winningTurn = turn;
+      winningKey = turnKey;
+    }
+  }
+  if (winningTurn != turns.end()) {
+    const Player winner = makePlayer(winningTurn->finalState, playerId);
+    bestPlay = {winningTurn->movements, winner.punctuation()};
+  } else if (turns.empty()) {
+    // There are no possible movements, so evaluate the current state
+    bestPlay.score =
+        evaluateState(playerId, nextPlayer, depth, rollsInARow, window);
+  } else if (searchInParallel(*this, depth, turns.size())) {
+    // Evaluate every state with the needed depth.
+    // They are evaluated at the same time, so they cannot use the best score
+    // found by the rest.
+    std::pmr::vector<double> evaluations(turns.size(), &arena);
+    forEachChild(*this, depth, turns.size(), [&](std::size_t i) {
+      // Every worker needs its own game to make the turn on
+      Game child = *this;
+      evaluations[i] = evaluateTurnInDepth(child, turns[i], playerId,
+                                           nextPlayer, depth, rollsInARow,
+                                           window);
+    });
+
+    // On a tie, the turn with the lowest tieBreakKey is kept
+    std::uint64_t bestKey = UINT64_MAX;
+    for (std::size_t i = 0; i < turns.size(); i++) {
+      // If the state is better that the best found till now, update the
+      // movements
+      const std::uint64_t turnKey = tieBreakKey(turns[i], playerId);
+      bool isBetter = evaluations[i] < bestPlay.score ||
+                      (evaluations[i] == bestPlay.score && turnKey < bestKey);
+      if (isBetter) {
+        bestPlay = {turns[i].movements, evaluations[i]};
+        bestKey = turnKey;
+      }
+    }
+  } else {
+    const bool pruning = isPruningEnabled(*this);
+    std::pmr::vector<std::size_t> order(&arena);
+    if (pruning) {
+      // The sooner a good turn is found, the more the rest can be pruned
+      SearchStats::Timer timer(stats ? &stats->orderingTime : nullptr);
+      order = orderTurns(*this, turns, playerId, nextPlayer, depth,
+                         rollsInARow);
+    } else {
+      order.resize(turns.size());
+      for (std::size_t i = 0; i < order.size(); i++) order[i] = i;
     }
 
-    // Evaluate the current state with the needed depth
-    double evaluation = evaluateStateInDepth(turn.finalState, player,
-                                             nextPlayer, depth, rollsInARow);
-    // If the state is better that the best found till now, update the
-    // movements
-    if (evaluation < bestPlay.score) {
-      bestPlay = {turn.movements, evaluation};
+    // All the turns are made on the same game, which keeps the same cache
+    // and workers
+    Game child = *this;
+    // On a tie, the turn with the lowest tieBreakKey is kept
+    std::uint64_t bestKey = UINT64_MAX;
+    for (std::size_t i : order) {
+      const std::uint64_t turnKey = tieBreakKey(turns[i], playerId);
+      SearchWindow turnWindow = window;
+      if (pruning) {
+        // Only a better turn can change the result. A tie is better if the
+        // turn comes first on ties.
+        double beta = (turnKey < bestKey)
+                          ? std::nextafter(bestPlay.score, INFINITY)
+                          : bestPlay.score;
+        turnWindow.beta = std::min(window.beta, beta);
+      }
+
+      double evaluation =
+          evaluateTurnInDepth(child, turns[i], playerId, nextPlayer, depth,
+                              rollsInARow, turnWindow);
+      bool isBetter = evaluation < bestPlay.score ||
+                      (evaluation == bestPlay.score && turnKey < bestKey);
+      if (isBetter) {
+        bestPlay = {turns[i].movements, evaluation};
+        bestKey = turnKey;
+      }
+
+      // The caller will not choose this node
+      if (pruning && bestPlay.score <= window.alpha) break;
     }
   }
 
-  // There are no more possible movements, so evaluate the current state
-  if (turns.empty()) {
-    bestPlay.score = evaluateStateInDepth(getState(), player, nextPlayer, depth,
-                                          rollsInARow);
+  if (transpositionTable) {
+    auto bound = TranspositionTable::Bound::EXACT;
+    if (bestPlay.score <= window.alpha) {
+      bound = TranspositionTable::Bound::UPPER;
+    } else if (bestPlay.score >= window.beta) {
+      bound = TranspositionTable::Bound::LOWER;
+    }
+    transpositionTable->store(key, depth, switchCacheSide(bestPlay, playerId),
+                              bound);
+  }
+
+  // The nested nodes on the same thread are counted by the outermost one
+  if (stats && arenaScope.isOutermost()) {
+    Arena::Stats arenaStats = arenaScope.stats();
+    SearchStats::add(stats->arenaAllocations, arenaStats.allocations);
+    SearchStats::add(stats->arenaBytes, arenaStats.bytes);
+    SearchStats::add(stats->arenaBlocks, arenaStats.blocks);
   }
 
   // Return the best movements
   return bestPlay;
 };
 
+AnytimePlay Game::bestPlayInBudget(PlayerNumber playerId, DicePairRoll dices,
+                                   SearchBudget& budget,
+                                   unsigned int rollsInARow /*= 1*/) const {
+  // There is nothing to decide, so the only play is scored as it is, without
+  // searching nor preparing the iterations
+  std::vector<Turn> turns;
+  generateTurns(playerId, dices, rollsInARow, turns);
+  if (turns.size() <= 1) {
+    ScoredPlay onlyPlay;
+    Game child = *this;
+    if (!turns.empty()) {
+      onlyPlay.play = turns.front().movements;
+      for (const Move& move : onlyPlay.play) child.makeMove(move);
+    }
+    onlyPlay.score = hasWon(child.getState(), playerId)
+                         ? child.getPlayer(playerId).punctuation()
+                         : child.nonRecursiveEvaluateState(playerId);
+    return {onlyPlay};
+  }
+
+  SearchContext context = searchContext ? *searchContext : SearchContext{};
+  // Every iteration orders its turns with the results of the previous one,
+  // so there must be a table to keep them
+  std::optional<TranspositionTable> ownTable;
+  if (!context.transpositionTable) {
+    context.transpositionTable = &ownTable.emplace();
+  }
+  Game searchedGame = *this;
+  searchedGame.setSearchContext(&context);
+
+  AnytimePlay result{searchedGame.bestPlay(playerId, dices, rollsInARow, 0)};
+  context.budget = &budget;
+  for (unsigned int depth = 1; depth <= budget.getMaxDepth(); depth++) {
+    try {
+      result = {searchedGame.bestPlay(playerId, dices, rollsInARow, depth),
+                depth};
+    } catch (const SearchBudget::Exhausted&) {
+      break;
+    }
+  }
+
+  return result;
+}
+
 Game Game::stateAfterMovement(const Player& player, Position ori,
                               unsigned int positionsToMove) const {
-  Players copiedPlayers = players;
+  Players copiedPlayers = getPlayers();
   Player& playerToMove = copiedPlayers[player.playerNumber - 1];
   try {
-    playerToMove.movePiece(ori, positionsToMove, barriers);
+    playerToMove.movePiece(ori, positionsToMove, board.barriers());
   } catch (const Player::WrongMove& moveException) {
     std::ostringstream oss;
     oss << "Piece at position " << ori << " cannot be moved with a "
@@ -721,27 +1213,22 @@ Game Game::stateAfterMovement(const Player& player, Position ori,
 }
 
 Position Game::getLastTouched(PlayerNumber playerNumber) const {
-  constexpr std::size_t nPlayers{std::tuple_size<decltype(players)>()};
-  if (playerNumber >= nPlayers) {
-    throw std::invalid_argument("Got a non existing player");
-  }
-
-  return lastTouched[playerNumber - 1];
+  checkPlayer(playerNumber);
+  return state.lastTouched[playerNumber - 1];
 };
 
 void Game::setLastTouched(PlayerNumber playerNumber,
                           Position lastTouchedPosition) {
-  Player& playerToUpdate = getPlayer(playerNumber);
-  setLastTouched(playerToUpdate, lastTouchedPosition);
-};
-
-void Game::setLastTouched(const Player& player, Position lastTouchedPosition) {
-  const Player::Pieces& pieces = player.pieces;
+  checkPlayer(playerNumber);
+  const GameState::Pieces& pieces = state.getPieces(playerNumber);
   auto itLastTouched =
       std::find(pieces.begin(), pieces.end(), lastTouchedPosition);
   if (itLastTouched == pieces.end()) {
     throw Player::PieceNotFound("Wrong piece as last moved");
   }
 
-  lastTouched[player.playerNumber - 1] = lastTouchedPosition;
+  GameState::Square& lastTouched = state.lastTouched[playerNumber - 1];
+  hash += zobristLastTouched(playerNumber, lastTouchedPosition) -
+          zobristLastTouched(playerNumber, lastTouched);
+  lastTouched = lastTouchedPosition;
 };
\ No newline at end of file
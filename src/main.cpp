@@ -1,24 +1,158 @@
-#include <iostream>
+#include <cstddef>    // for size_t
+#include <cstdint>    // for uint64_t
+#include <exception>  // for exception
+#include <iostream>   // for operator<<, basic_ostream, cerr, cout, cin
+#include <optional>   // for optional
+#include <string>     // for string, stoul, stoull
 
-#include "game.hpp"
-#include "player.hpp"
-#include "table.hpp"
+#include "advisor.hpp"              // for Advisor
+#include "dices.hpp"                // for DicePairRoll
+#include "endgame_table.hpp"        // for EndgameTable
+#include "game.hpp"                 // for Game, Play, Move, Game::Players
+#include "opening_book.hpp"         // for OpeningBook
+#include "player.hpp"               // for Player
+#include "position_stream.hpp"      // for analyzeStream
+#include "search_context.hpp"       // for SearchContext
+#include "search_stats.hpp"         // for SearchStats, operator<<
+#include "self_play.hpp"            // for Policies, makePolicy, searchPolicy
+#include "table.hpp"                // for PlayerNumber, Position, GOAL
+#include "thread_pool.hpp"          // for ThreadPool
+#include "transposition_table.hpp"  // for TranspositionTable
 
 void printBestPlay(const Play& play) {
   for (const Move& move : play) {
-    std::cout << "Player number " << move.player << " move piece from "
-              << move.origin << " to " << move.dest << "\n";
+    std::cout << "Player number " << static_cast<PlayerNumber>(move.player)
+              << " move piece from " << static_cast<Position>(move.origin)
+              << " to " << static_cast<Position>(move.dest) << "\n";
   }
 }
 
-int main() {
+// Answers the queries written on the standard input until it ends
+int runStream(unsigned int depth, unsigned int nThreads,
+              const EndgameTable* endgameTable,
+              const OpeningBook* openingBook) {
+  std::ios::sync_with_stdio(false);
+  Advisor advisor(depth, nThreads);
+  advisor.setEndgameTable(endgameTable);
+  advisor.setOpeningBook(openingBook);
+  analyzeStream(std::cin, std::cout, advisor);
+  return 0;
+}
+
+// Plays the games and prints how they went
+int runSelfPlay(std::size_t nGames, const Policies& policies,
+                std::uint64_t seed, unsigned int nThreads) {
+  ThreadPool threadPool(nThreads);
+  std::cout << simulateGames(policies, nGames, seed, &threadPool);
+  return 0;
+}
+
+void printUsage(const char* program) {
+  std::cerr << "Usage: " << program
+            << " [--stream] [--depth <depth>] [--threads <threads>]"
+               " [--endgame <table>] [--book <book>]\n"
+            << "       " << program
+            << " --self-play <games> [--players <policy> <policy>]"
+               " [--seed <seed>] [--threads <threads>]\n"
+            << "A policy is \"random\" or the depth of the search, which"
+               " does not use the endgame table nor the opening book\n"
+            << "The endgame table is written by generate_endgame_table\n"
+            << "The opening book is written by generate_opening_book\n";
+}
+
+int main(int argc, char* argv[]) {
+  bool stream{false};
+  unsigned int depth{2};
+  unsigned int nThreads{0};
+  std::size_t selfPlayGames{0};
+  Policies policies{searchPolicy(0), searchPolicy(0)};
+  std::uint64_t seed{0};
+  std::optional<std::string> endgamePath;
+  std::optional<std::string> bookPath;
+  for (int i = 1; i < argc; i++) {
+    std::string argument{argv[i]};
+    try {
+      if (argument == "--stream") {
+        stream = true;
+      } else if (argument == "--depth" && i + 1 < argc) {
+        depth = std::stoul(argv[++i]);
+      } else if (argument == "--threads" && i + 1 < argc) {
+        nThreads = std::stoul(argv[++i]);
+      } else if (argument == "--self-play" && i + 1 < argc) {
+        selfPlayGames = std::stoull(argv[++i]);
+      } else if (argument == "--players" && i + 2 < argc) {
+        policies = {makePolicy(argv[i + 1]), makePolicy(argv[i + 2])};
+        i += 2;
+      } else if (argument == "--seed" && i + 1 < argc) {
+        seed = std::stoull(argv[++i]);
+      } else if (argument == "--endgame" && i + 1 < argc) {
+        endgamePath = argv[++i];
+      } else if (argument == "--book" && i + 1 < argc) {
+        bookPath = argv[++i];
+      } else {
+        printUsage(argv[0]);
+        return 1;
+      }
+    } catch (const std::exception&) {
+      printUsage(argv[0]);
+      return 1;
+    }
+  }
+  // The policies of the self-play search without them
+  if (selfPlayGames > 0 && (endgamePath || bookPath)) {
+    std::cerr << "--endgame and --book cannot be used with --self-play\n";
+    return 1;
+  }
+
+  std::optional<EndgameTable> endgameTable;
+  if (endgamePath) {
+    try {
+      endgameTable = EndgameTable::load(*endgamePath);
+    } catch (const EndgameTable::InvalidFile& error) {
+      std::cerr << error.what() << "\n";
+      return 1;
+    }
+  }
+  const EndgameTable* endgame = endgameTable ? &*endgameTable : nullptr;
+
+  std::optional<OpeningBook> openingBook;
+  if (bookPath) {
+    try {
+      openingBook.emplace(OpeningBook::open(*bookPath));
+    } catch (const OpeningBook::InvalidFile& error) {
+      std::cerr << error.what() << "\n";
+      return 1;
+    }
+  }
+  const OpeningBook* book = openingBook ? &*openingBook : nullptr;
+  if (book && depth != book->depth()) {
+    std::cerr << "The opening book was searched with depth " << book->depth()
+              << ", so it is not used by searches of depth " << depth << "\n";
+  }
+
+  if (stream) return runStream(depth, nThreads, endgame, book);
+  if (selfPlayGames > 0) {
+    return runSelfPlay(selfPlayGames, policies, seed, nThreads);
+  }
+
   Game::Players players{Player({1, {1, 34, 11, 7}}),
                         Player({2, {GOAL - 3, 47, 35, 41}})};
 
   DicePairRoll roll{1, 2};
   Game game(players);
-  auto bestPlay = game.bestPlay(1, roll, 1, 2);
+  TranspositionTable transpositionTable;
+  ThreadPool threadPool(nThreads);
+  // The last levels are searched on a single thread so they can be pruned
+  SearchContext searchContext{&transpositionTable, &threadPool, 2};
+  SearchStats searchStats;
+  searchContext.stats = &searchStats;
+  searchContext.endgameTable = endgame;
+  searchContext.openingBook = book;
+  game.setSearchContext(&searchContext);
+  auto bestPlay = game.bestPlay(1, roll, 1, depth);
   printBestPlay(bestPlay.play);
 
+  if constexpr (SearchStats::ENABLED) std::cout << searchStats;
+
   return 0;
 }
@@ -0,0 +1,67 @@
+#include "mapped_file.hpp"
+
+#include <fstream>   // for ifstream
+#include <iterator>  // for istreambuf_iterator
+#include <utility>   // for swap
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>     // for open, O_RDONLY
+#include <sys/mman.h>  // for mmap, munmap
+#include <sys/stat.h>  // for fstat
+#include <unistd.h>    // for close
+#define PARCHIS_MAP_FILES
+#endif
+
+std::optional<MappedFile> MappedFile::open(const std::string& path) {
+  MappedFile mapped;
+
+#ifdef PARCHIS_MAP_FILES
+  int file = ::open(path.c_str(), O_RDONLY);
+  if (file < 0) return std::nullopt;
+  struct stat info;
+  if (fstat(file, &info) != 0) {
+    close(file);
+    return std::nullopt;
+  }
+  // An empty file cannot be mapped, and there is nothing to map either
+  mapped.length = static_cast<std::size_t>(info.st_size);
+  if (mapped.length > 0) {
+    void* memory =
+        mmap(nullptr, mapped.length, PROT_READ, MAP_PRIVATE, file, 0);
+    if (memory == MAP_FAILED) {
+      close(file);
+      return std::nullopt;
+    }
+    mapped.mapping = memory;
+    mapped.begin = static_cast<const char*>(memory);
+  }
+  close(file);
+#else
+  std::ifstream file(path, std::ios::binary);
+  if (!file) return std::nullopt;
+  mapped.buffer.assign(std::istreambuf_iterator<char>(file),
+                       std::istreambuf_iterator<char>());
+  mapped.begin = mapped.buffer.data();
+  mapped.length = mapped.buffer.size();
+#endif
+
+  return mapped;
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept {
+  *this = std::move(other);
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+  std::swap(mapping, other.mapping);
+  std::swap(buffer, other.buffer);
+  std::swap(begin, other.begin);
+  std::swap(length, other.length);
+  return *this;
+}
+
+MappedFile::~MappedFile() {
+#ifdef PARCHIS_MAP_FILES
+  if (mapping) munmap(mapping, length);
+#endif
+}
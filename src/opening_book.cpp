@@ -0,0 +1,143 @@
+#include "opening_book.hpp"
+
+#include <algorithm>    // for copy, lower_bound, sort
+#include <cstdint>      // for uint32_t
+#include <cstring>      // for memcpy
+#include <fstream>      // for ofstream
+#include <type_traits>  // for is_trivially_copyable_v
+#include <utility>      // for move
+
+// Written at the start of the file, followed by the entries
+struct FileHeader {
+  std::array<char, 8> magic;
+  std::uint32_t version;
+  std::uint32_t entries;
+  // Depth all the plays were searched with
+  std::uint32_t depth;
+  // Up to the alignment of the entries
+  std::uint32_t padding;
+};
+
+static constexpr std::array<char, 8> FILE_MAGIC{'P', 'A', 'R', 'C',
+                                                'H', 'I', 'S', 'O'};
+// Version 2 stores the plays of player 2 mirrored, as the transposition table.
+// Version 3 keys the plays without the depth and stores it in the header.
+// Version 4 packs the pieces of the keys as canonicalKey.
+static constexpr std::uint32_t FILE_VERSION = 4;
+
+// The entries are used right from the file
+static_assert(std::is_trivially_copyable_v<OpeningBook::Entry>);
+// The movements are written as they are, a byte for each field
+static_assert(sizeof(Move) == 3);
+// There is no padding the compiler could leave uninitialized
+static_assert(sizeof(OpeningBook::Entry) ==
+              sizeof(TranspositionTable::Key) + sizeof(double) +
+                  sizeof(std::uint8_t) + sizeof(Move) * MAX_TURN_MOVES +
+                  sizeof(OpeningBook::Entry::padding));
+static_assert(sizeof(FileHeader) % alignof(OpeningBook::Entry) == 0);
+
+static bool keyLess(const TranspositionTable::Key& lhs,
+                    const TranspositionTable::Key& rhs) {
+  if (lhs.pieces != rhs.pieces) return lhs.pieces < rhs.pieces;
+  return lhs.context < rhs.context;
+}
+
+OpeningBook OpeningBook::open(const std::string& path) {
+  std::optional<MappedFile> file = MappedFile::open(path);
+  if (!file) throw InvalidFile("Cannot open the opening book " + path);
+  OpeningBook book(std::move(*file));
+  const char* begin = book.file.data();
+  const std::size_t size = book.file.size();
+
+  FileHeader header;
+  if (size < sizeof(header)) {
+    throw InvalidFile(path + " is not an opening book");
+  }
+  std::memcpy(&header, begin, sizeof(header));
+  if (header.magic != FILE_MAGIC) {
+    throw InvalidFile(path + " is not an opening book");
+  }
+  if (header.version != FILE_VERSION) {
+    throw InvalidFile(path + " is an opening book of another version");
+  }
+  // Compared by dividing, so a corrupted count cannot overflow
+  const std::size_t entriesSize = size - sizeof(header);
+  if (entriesSize % sizeof(Entry) != 0 ||
+      entriesSize / sizeof(Entry) != header.entries) {
+    throw InvalidFile("The opening book " + path + " is truncated");
+  }
+
+  // The entries are not touched until they are probed, which is when they
+  // are checked
+  book.entries = reinterpret_cast<const Entry*>(begin + sizeof(header));
+  book.nEntries = header.entries;
+  book.searchDepth = header.depth;
+  return book;
+}
+
+void OpeningBook::write(
+    const std::string& path, unsigned int depth,
+    const std::vector<std::pair<TranspositionTable::Key, ScoredPlay>>& plays) {
+  std::vector<Entry> entries;
+  entries.reserve(plays.size());
+  for (const auto& [key, scoredPlay] : plays) {
+    if (scoredPlay.play.size() > MAX_TURN_MOVES) {
+      throw std::invalid_argument("The play is too long for the book");
+    }
+
+    // The padding is a member too, so it is cleared and the same plays
+    // always give the same file
+    Entry entry{};
+    entry.key = key;
+    entry.score = scoredPlay.score;
+    entry.nMovements = static_cast<std::uint8_t>(scoredPlay.play.size());
+    std::copy(scoredPlay.play.begin(), scoredPlay.play.end(),
+              entry.movements.begin());
+    entries.push_back(entry);
+  }
+  std::sort(entries.begin(), entries.end(),
+            [](const Entry& lhs, const Entry& rhs) {
+              return keyLess(lhs.key, rhs.key);
+            });
+
+  std::ofstream file(path, std::ios::binary);
+  FileHeader header{FILE_MAGIC, FILE_VERSION,
+                    static_cast<std::uint32_t>(entries.size()), depth, 0};
+  file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  file.write(reinterpret_cast<const char*>(entries.data()),
+             entries.size() * sizeof(Entry));
+  if (!file) throw InvalidFile("Cannot write the opening book " + path);
+}
+
+TranspositionTable::Key OpeningBook::key(const Game::Turn::FinalState& state,
+                                         PlayerNumber player,
+                                         const DicePairRoll& dices,
+                                         unsigned int rollsInARow) {
+  // The depth is the same for all the book, so the one of the keys is fixed
+  return TranspositionTable::decisionKey(state, player, dices, 0, rollsInARow);
+}
+
+std::optional<ScoredPlay> OpeningBook::probe(
+    const TranspositionTable::Key& key) const {
+  const Entry* end = entries + nEntries;
+  const Entry* found = std::lower_bound(
+      entries, end, key, [](const Entry& entry, const auto& searched) {
+        return keyLess(entry.key, searched);
+      });
+  if (found == end || !(found->key == key)) return std::nullopt;
+
+  // Only the entries the search went through are checked. The neighbours
+  // of the one found tell whether the binary search could be trusted.
+  if ((found != entries && !keyLess((found - 1)->key, found->key)) ||
+      (found + 1 != end && !keyLess(found->key, (found + 1)->key))) {
+    throw InvalidFile("The opening book is not sorted");
+  }
+  if (found->nMovements > MAX_TURN_MOVES) {
+    throw InvalidFile("The opening book has a play too long");
+  }
+
+  ScoredPlay scoredPlay{{}, found->score};
+  scoredPlay.play.assign(found->movements.begin(),
+                         found->movements.begin() + found->nMovements);
+  return scoredPlay;
+}
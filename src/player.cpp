@@ -1,15 +1,18 @@
 #include "player.hpp"
 
-#include <algorithm>  // for find, all_of
+#include <algorithm>  // for find, all_of, max
 #include <array>      // for array, array<>::const_iterator, array<>::iterator
-#include <set>        // for set, operator==, set<>::const_iterator
+#include <optional>   // for optional, nullopt
 #include <sstream>    // for operator<<, ostringstream, basic_ostream, basic...
+#include <stdexcept>  // for invalid_argument
 
-#include "dices.hpp"  // for getDiceValProbability, OUT_OF_HOME, averageDice...
-#include "table.hpp"  // for Position, getPlayerInitialPosition, getPlayerLa...
+#include "board.hpp"       // for SquareMask
+#include "dices.hpp"       // for getDiceValProbability, OUT_OF_HOME, avera...
+#include "game_state.hpp"  // for N_PLAYERS
+#include "move_table.hpp"  // for getDestination, getDistanceToGoal, NO_DES...
+#include "table.hpp"       // for Position, getPlayerInitialPosition, GOAL
 
-static double piecePunctuation(Position piece, Position finalPosition,
-                               Position initialPosition) {
+static constexpr double piecePunctuation(PlayerNumber player, Position piece) {
   // If the piece got to the goal, there is no need of moving it
   if (piece == GOAL) return 0.0;
 
@@ -21,104 +24,123 @@ static double piecePunctuation(Position piece, Position finalPosition,
   }
 
   // There is path to move until getting to the hallway
+  unsigned int distanceToGoal = getDistanceToGoal(player, piece);
   if (piece < firstHallway) {
-    Position playingPosition = (piece == HOME) ? initialPosition : piece;
-    punctuation += distanceToPosition(playingPosition, finalPosition);
+    // Do not count the step into the hallway nor the hallway itself
+    punctuation += distanceToGoal - hallwayLength - 1;
+    distanceToGoal = hallwayLength;
   }
 
   // Add the average dices rolls to get to the goal from the final hallway
-  unsigned int distanceToGoal =
-      (piece < firstHallway) ? hallwayLength : (GOAL - piece);
   punctuation += 1 / getDiceValProbability(distanceToGoal) * averageDiceRoll;
 
   return punctuation;
 }
 
-double Player::punctuation() const {
-  double punctuation{0.0};
+using PunctuationTable = std::array<std::array<double, GOAL + 1>, N_PLAYERS>;
 
-  Position finalPosition{getPlayerLastPosition(playerNumber)};
-  Position initialPosition{getPlayerInitialPosition(playerNumber)};
-  for (Position piece : pieces) {
-    punctuation += piecePunctuation(piece, finalPosition, initialPosition);
+static constexpr PunctuationTable loadPunctuationTable() {
+  PunctuationTable table{};
+  for (PlayerNumber player = 1; player <= N_PLAYERS; player++) {
+    for (Position piece = HOME; piece <= GOAL; piece++) {
+      if (piece > totalPositions && piece < firstHallway) continue;
+      table[player - 1][piece] = piecePunctuation(player, piece);
+    }
   }
 
-  if (punctuation== 0)
-    return -5000;
-  return punctuation;
-}
-
-unsigned int Player::countPiecesInPosition(Position targetPosition) const {
-  return std::count(pieces.begin(), pieces.end(), targetPosition);
+  return table;
 }
 
-static Position destinyPosition(Position pieceToMove,
-                                unsigned int positionsToMove,
-                                PlayerNumber playerNumber) {
-  // If the piece is at home the only move it can make is exit
-  if (pieceToMove == HOME) {
-    if (positionsToMove == OUT_OF_HOME) {
-      pieceToMove = getPlayerInitialPosition(playerNumber);
-    } else {
-      std::ostringstream oss;
-      oss << "A piece at home cannot be moved with a " << positionsToMove
-          << ".";
-      throw Player::WrongMove(oss.str());
+static constexpr PunctuationTable PUNCTUATION_TABLE = loadPunctuationTable();
+
+// Highest punctuation a piece can have after moving forward from a position.
+// Moving forward does not always lower the punctuation: in the hallway, the
+// closer to the goal, the harder is to get the exact number.
+static constexpr PunctuationTable loadReachablePunctuationTable() {
+  PunctuationTable table = PUNCTUATION_TABLE;
+  for (PlayerNumber player = 1; player <= N_PLAYERS; player++) {
+    for (Position piece = finalHallway; piece >= firstHallway; piece--) {
+      table[player - 1][piece] =
+          std::max(table[player - 1][piece], table[player - 1][piece + 1]);
     }
   }
-  // The piece is in a common position
-  else if (isCommonPosition(pieceToMove)) {
-    Position finalPosition = getPlayerLastPosition(playerNumber);
-    unsigned int distanceToHallWay =
-        1 + distanceToPosition(pieceToMove, finalPosition);
-
-    // If the piece advance all the positions the dice say it does not get into
-    // the hallway
-    if (distanceToHallWay > positionsToMove) {
-      // Correct the number if it has gone further than the position 1
-      pieceToMove = correctPosition(pieceToMove + positionsToMove);
-    }
-    // The piece will get to the hallway. Let's check it can move that far
-    else {
-      unsigned int distanceToGoal = distanceToHallWay + hallwayLength;
-      if (distanceToGoal < positionsToMove) {
-        std::ostringstream oss;
-        oss << "There is not space enough to move " << positionsToMove
-            << " positions.";
-        throw Player::WrongMove(oss.str());
+
+  return table;
+}
+
+static constexpr PunctuationTable REACHABLE_PUNCTUATION_TABLE =
+    loadReachablePunctuationTable();
+
+// Checks no movement gets to a position with a higher reachable punctuation
+static constexpr bool isReachablePunctuationTableRight() {
+  for (PlayerNumber player = 1; player <= N_PLAYERS; player++) {
+    const auto& reachable = REACHABLE_PUNCTUATION_TABLE[player - 1];
+    for (Position piece = HOME; piece <= GOAL; piece++) {
+      if (piece > totalPositions && piece < firstHallway) continue;
+      if (reachable[piece] < PUNCTUATION_TABLE[player - 1][piece]) {
+        return false;
+      }
+      for (unsigned int advance : TABULATED_ADVANCES) {
+        Position destination = getDestination(player, piece, advance);
+        if (destination == NO_DESTINATION) continue;
+        if (reachable[destination] > reachable[piece]) return false;
       }
-      pieceToMove = firstHallway + positionsToMove - distanceToHallWay;
     }
   }
-  // The piece is in the final hallway
-  else if (isHallwayPosition(pieceToMove)) {
-    unsigned int distanceToGoal = GOAL - pieceToMove;
-    if (distanceToGoal < positionsToMove) {
-      std::ostringstream oss;
-      oss << "There is not space enough to move " << positionsToMove
-          << " positions.";
-      throw Player::WrongMove(oss.str());
-    }
-    pieceToMove += positionsToMove;
+
+  return true;
+}
+static_assert(isReachablePunctuationTableRight());
+
+template <typename Pieces>
+static double sumPunctuation(PlayerNumber playerNumber, const Pieces& pieces) {
+  if (playerNumber < 1 || playerNumber > N_PLAYERS) {
+    throw std::invalid_argument("Got a non existing player");
+  }
+
+  double punctuation{0.0};
+  for (Position piece : pieces) {
+    punctuation += PUNCTUATION_TABLE[playerNumber - 1][piece];
   }
-  // I cannot move a piece that has reached the goal
-  else if (pieceToMove == GOAL) {
-    throw Player::WrongMove("Piece on goal cannot be moved.");
+
+  if (punctuation== 0)
+    return Player::WON_PUNCTUATION;
+  return punctuation;
+}
+
+double Player::punctuation() const {
+  return sumPunctuation(playerNumber, pieces);
+}
+
+double Player::piecesPunctuation(PlayerNumber playerNumber,
+                                 const GameState::Pieces& pieces) {
+  return sumPunctuation(playerNumber, pieces);
+}
+
+double Player::maxReachablePunctuation(PlayerNumber playerNumber,
+                                       const GameState::Pieces& pieces) {
+  double punctuation{0.0};
+  for (Position piece : pieces) {
+    punctuation += REACHABLE_PUNCTUATION_TABLE[playerNumber - 1][piece];
   }
 
-  return pieceToMove;
+  return punctuation;
+}
+
+unsigned int Player::countPiecesInPosition(Position targetPosition) const {
+  return std::count(pieces.begin(), pieces.end(), targetPosition);
 }
 
 static bool existBarriersBetweenPositions(Position origin, Position destiny,
-                                          const std::set<Position>& barriers) {
+                                          const SquareMask& barriers) {
   // Tests the range (origin, destiny]
-  return barriers.upper_bound(origin) != barriers.upper_bound(destiny);
+  return (barriers & SquareMask::range(origin + 1, destiny)).any();
 }
 
 static bool existBlockingBarriers(Position origin, Position destiny,
-                                  const std::set<Position>& barriers) {
+                                  const SquareMask& barriers) {
   // If there are not barriers at all, exit the function
-  if (barriers.empty()) return false;
+  if (barriers.none()) return false;
 
   // I expect the destiny position to be right
   // Just have to check there are no barriers on the initial position
@@ -132,6 +154,8 @@ static bool existBlockingBarriers(Position origin, Position destiny,
 
   // There are not barriers in the hallway
   if (isHallwayPosition(origin)) return false;
+  // The piece was on the last common position and only crosses the hallway
+  if (origin == destiny) return false;
 
   // Origin is regular position, I have to check there are no barriers ahead
 
@@ -141,8 +165,7 @@ static bool existBlockingBarriers(Position origin, Position destiny,
   } else {
     // Check two segments and also the position number 1
     return existBarriersBetweenPositions(origin, totalPositions, barriers) ||
-           barriers.find(1) != barriers.end() ||
-           existBarriersBetweenPositions(1, destiny, barriers);
+           existBarriersBetweenPositions(HOME, destiny, barriers);
   }
 }
 
@@ -153,30 +176,97 @@ bool Player::canGoToInitialPosition() const {
   return countPiecesInPosition(initialPosition) < 2;
 }
 
+// Checks whether something stops the piece on origin from getting to destiny
+static bool isBlocked(PlayerNumber playerNumber, bool canGoToInitialPosition,
+                      Position origin, Position destiny,
+                      const SquareMask& barriers) {
+  // Exiting from home only depends on my own pieces
+  if (origin == HOME) return !canGoToInitialPosition;
+  // A piece getting into the hallway only crosses the common positions until
+  // the last one of its player
+  if (!isCommonPosition(destiny)) {
+    destiny = getPlayerLastPosition(playerNumber);
+  }
+  return existBlockingBarriers(origin, destiny, barriers);
+}
+
+static bool isBlocked(const Player& player, Position origin, Position destiny,
+                      const SquareMask& barriers) {
+  return isBlocked(player.playerNumber,
+                   origin == HOME && player.canGoToInitialPosition(), origin,
+                   destiny, barriers);
+}
+
+std::optional<Position> Player::destination(Position pieceToMove,
+                                            unsigned int positionsToMove,
+                                            const SquareMask& barriers) const {
+  if (countPiecesInPosition(pieceToMove) == 0) return std::nullopt;
+
+  Position destiny = getDestination(playerNumber, pieceToMove, positionsToMove);
+  if (destiny == NO_DESTINATION ||
+      isBlocked(*this, pieceToMove, destiny, barriers)) {
+    return std::nullopt;
+  }
+
+  return destiny;
+}
+
+std::optional<Position> Player::destination(PlayerNumber playerNumber,
+                                            Position pieceToMove,
+                                            unsigned int positionsToMove,
+                                            const Board& board,
+                                            const SquareMask& barriers) {
+  Position destiny = getDestination(playerNumber, pieceToMove, positionsToMove);
+  if (destiny == NO_DESTINATION) return std::nullopt;
+
+  bool canGoToInitialPosition =
+      pieceToMove == HOME &&
+      board.count(playerNumber, getPlayerInitialPosition(playerNumber)) < 2;
+  if (isBlocked(playerNumber, canGoToInitialPosition, pieceToMove, destiny,
+                barriers)) {
+    return std::nullopt;
+  }
+
+  return destiny;
+}
+
+std::optional<Position> Player::tryMovePiece(Position pieceToMove,
+                                             unsigned int positionsToMove,
+                                             const SquareMask& barriers) {
+  std::optional<Position> destiny =
+      destination(pieceToMove, positionsToMove, barriers);
+  if (destiny) *std::find(pieces.begin(), pieces.end(), pieceToMove) = *destiny;
+
+  return destiny;
+}
+
 Position Player::movePiece(Position pieceToMove, unsigned int positionsToMove,
-                           const std::set<Position>& barriers) {
+                           const SquareMask& barriers) {
   // Check I have the piece I was asked to move
   auto itPieceToMove = std::find(pieces.begin(), pieces.end(), pieceToMove);
   if (itPieceToMove == pieces.end())
     throw PieceNotFound("No piece to be moved");
   Position& toMove = *itPieceToMove;
 
-  Position destiny = destinyPosition(toMove, positionsToMove, playerNumber);
+  // The messages are only built when the movement is wrong
+  Position destiny = getDestination(playerNumber, toMove, positionsToMove);
+  if (destiny == NO_DESTINATION) {
+    std::ostringstream oss;
+    oss << "A piece on " << toMove << " cannot be moved " << positionsToMove
+        << " positions.";
+    throw Player::WrongMove(oss.str());
+  }
 
   // Check the movement can be performed
-  if (pieceToMove == HOME) {
-    if (!canGoToInitialPosition()) {
-      std::ostringstream oss;
+  if (isBlocked(*this, toMove, destiny, barriers)) {
+    std::ostringstream oss;
+    if (pieceToMove == HOME) {
       oss << "Initial position is too busy for me to exit." << destiny << ".";
-      throw Player::WrongMove(oss.str());
-    }
-  } else {
-    if (existBlockingBarriers(toMove, destiny, barriers)) {
-      std::ostringstream oss;
-      oss << "There are barriers that don't allow to move " << toMove << " to "
-          << destiny << ".";
-      throw Player::WrongMove(oss.str());
+    } else {
+      oss << "There are barriers that don't allow to move " << toMove
+          << " to " << destiny << ".";
     }
+    throw Player::WrongMove(oss.str());
   }
 
   // Execute the movement
@@ -0,0 +1,169 @@
+#include "position_stream.hpp"
+
+#include <exception>  // for exception
+#include <istream>    // for istream, getline, ws
+#include <optional>   // for optional
+#include <ostream>    // for ostream, operator<<, flush
+#include <sstream>    // for istringstream, ostringstream
+#include <string>     // for string, to_string
+#include <thread>     // for thread
+#include <utility>    // for move
+#include <vector>     // for vector
+
+#include "bounded_queue.hpp"  // for BoundedQueue
+#include "dices.hpp"          // for DicePairRoll
+#include "game_state.hpp"     // for GameState, N_PIECES, N_PLAYERS
+#include "table.hpp"          // for HOME, GOAL, isCommonPosition, isHallw...
+
+static unsigned int readNumber(std::istringstream& iss, const char* what,
+                               long long min, long long max) {
+  long long number{0};
+  if (!(iss >> number)) {
+    bool missing = iss.eof();
+    throw ParseError(std::string(missing ? "Missing " : "Invalid ") + what);
+  }
+  if (number < min || number > max) {
+    std::ostringstream oss;
+    oss << "Invalid " << what << ": " << number;
+    throw ParseError(oss.str());
+  }
+  return static_cast<unsigned int>(number);
+}
+
+static bool isValidPosition(Position position) {
+  return position == HOME || position == GOAL || isCommonPosition(position) ||
+         isHallwayPosition(position);
+}
+
+Query parseQuery(const std::string& line) {
+  std::istringstream iss(line);
+  Query query{};
+
+  query.player = readNumber(iss, "player", 1, N_PLAYERS);
+  query.roll.first = readNumber(iss, "dice", 1, 6);
+  query.roll.second = readNumber(iss, "dice", 1, 6);
+
+  for (PlayerNumber player = 1; player <= N_PLAYERS; player++) {
+    for (GameState::Square& piece : query.state.getPieces(player)) {
+      Position position = readNumber(iss, "piece", HOME, GOAL);
+      if (!isValidPosition(position)) {
+        throw ParseError("Invalid piece: " + std::to_string(position));
+      }
+      piece = static_cast<GameState::Square>(position);
+    }
+    // As when a game is built from the players, the last touched piece is
+    // the first one
+    query.state.lastTouched[player - 1] = query.state.getPieces(player).front();
+  }
+
+  // The rolls in a row are optional
+  query.rollsInARow = 1;
+  if (!(iss >> std::ws).eof()) {
+    query.rollsInARow = readNumber(iss, "rolls in a row", 1, 3);
+  }
+  if (!(iss >> std::ws).eof()) throw ParseError("Too many values");
+
+  return query;
+}
+
+std::string formatPlay(const ScoredPlay& scoredPlay) {
+  std::ostringstream oss;
+  oss << scoredPlay.score;
+  for (const Move& move : scoredPlay.play) {
+    // The fields are bytes, print them as numbers
+    oss << " " << static_cast<PlayerNumber>(move.player) << ":"
+        << static_cast<Position>(move.origin) << "-"
+        << static_cast<Position>(move.dest);
+  }
+  return oss.str();
+}
+
+// A line of the input, already parsed
+struct ParsedLine {
+  std::optional<Query> query;
+  // Why the line is not a query
+  std::string error;
+};
+
+// Answers the queries of the batch, even if some of them cannot be answered
+static std::vector<std::string> answerBatch(
+    const std::vector<ParsedLine>& batch, Advisor& advisor) {
+  std::vector<Query> queries;
+  for (const ParsedLine& line : batch) {
+    if (line.query) queries.push_back(*line.query);
+  }
+
+  std::vector<std::optional<ScoredPlay>> plays(queries.size());
+  try {
+    std::vector<ScoredPlay> batchPlays = advisor.bestPlays(queries);
+    for (std::size_t i = 0; i < plays.size(); i++) {
+      plays[i] = std::move(batchPlays[i]);
+    }
+  } catch (const std::exception&) {
+    // Find which ones failed asking for them one by one
+    for (std::size_t i = 0; i < plays.size(); i++) {
+      try {
+        plays[i] = advisor.bestPlay(queries[i]);
+      } catch (const std::exception&) {
+      }
+    }
+  }
+
+  std::vector<std::string> answers;
+  answers.reserve(batch.size());
+  std::size_t iPlay = 0;
+  for (const ParsedLine& line : batch) {
+    if (!line.query) {
+      answers.push_back("error " + line.error);
+    } else if (const auto& play = plays[iPlay++]) {
+      answers.push_back(formatPlay(*play));
+    } else {
+      answers.push_back("error The query could not be searched");
+    }
+  }
+
+  return answers;
+}
+
+void analyzeStream(std::istream& input, std::ostream& output,
+                   Advisor& advisor, const StreamOptions& options) {
+  BoundedQueue<ParsedLine> lines(options.queueCapacity);
+
+  // Reading from a tied stream flushes the output, and the output is written
+  // from this thread while the other one reads
+  std::ostream* tiedOutput = input.tie(nullptr);
+
+  std::thread reader([&] {
+    std::string line;
+    while (std::getline(input, line)) {
+      if (line.find_first_not_of(" \t\r") == std::string::npos) continue;
+
+      ParsedLine parsed;
+      try {
+        parsed.query = parseQuery(line);
+      } catch (const ParseError& error) {
+        parsed.error = error.what();
+      }
+      lines.push(std::move(parsed));
+    }
+    lines.close();
+  });
+
+  // Wait for a line, and take the ones that are already waiting with it
+  while (auto first = lines.pop()) {
+    std::vector<ParsedLine> batch{std::move(*first)};
+    while (batch.size() < options.batchSize) {
+      auto next = lines.tryPop();
+      if (!next) break;
+      batch.push_back(std::move(*next));
+    }
+
+    for (const std::string& answer : answerBatch(batch, advisor)) {
+      output << answer << "\n";
+    }
+    output << std::flush;
+  }
+
+  reader.join();
+  input.tie(tiedOutput);
+}
@@ -0,0 +1,24 @@
+#include "search_budget.hpp"
+
+SearchBudget::SearchBudget(Clock::duration time, std::size_t nodes,
+                           unsigned int maxDepth)
+    : time(time), maxNodes(nodes), maxDepth(maxDepth) {
+  restart();
+}
+
+void SearchBudget::restart() {
+  deadline = Clock::now() + time;
+  nodes = 0;
+  exhausted = false;
+}
+
+void SearchBudget::spendNode() {
+  std::size_t spent = ++nodes;
+  if (!exhausted) {
+    bool outOfNodes = maxNodes != 0 && spent > maxNodes;
+    bool outOfTime = time != Clock::duration::zero() && Clock::now() > deadline;
+    if (outOfNodes || outOfTime) exhausted = true;
+  }
+
+  if (exhausted) throw Exhausted("The search budget is spent");
+}
@@ -0,0 +1,56 @@
+#include "search_stats.hpp"
+
+#include <chrono>  // for duration, duration_cast
+
+std::size_t SearchStats::nodes() const {
+  std::size_t total = 0;
+  for (const Counter& counter : nodesPerDepth) total += counter;
+  return total;
+}
+
+void SearchStats::reset() {
+  for (Counter& counter : nodesPerDepth) counter = 0;
+  generatedTurns = 0;
+  duplicatedStates = 0;
+  movedBarriers = 0;
+  boostRecursions = 0;
+  leafEvaluations = 0;
+  cacheProbes = 0;
+  cacheHits = 0;
+  bookHits = 0;
+  arenaAllocations = 0;
+  arenaBytes = 0;
+  arenaBlocks = 0;
+  generationTime = 0;
+  orderingTime = 0;
+}
+
+static double milliseconds(SearchStats::Clock::rep time) {
+  using Milliseconds = std::chrono::duration<double, std::milli>;
+  return std::chrono::duration_cast<Milliseconds>(
+             SearchStats::Clock::duration(time))
+      .count();
+}
+
+std::ostream& operator<<(std::ostream& os, const SearchStats& stats) {
+  os << "Nodes: " << stats.nodes() << "\n";
+  for (unsigned int depth = SearchStats::MAX_DEPTH + 1; depth-- > 0;) {
+    std::size_t nodes = stats.nodesPerDepth[depth];
+    if (nodes == 0) continue;
+    os << "  depth " << depth << ": " << nodes << "\n";
+  }
+  os << "Generated turns: " << stats.generatedTurns << "\n"
+     << "Duplicated states: " << stats.duplicatedStates << "\n"
+     << "Moved barriers: " << stats.movedBarriers << "\n"
+     << "Boost recursions: " << stats.boostRecursions << "\n"
+     << "Leaf evaluations: " << stats.leafEvaluations << "\n"
+     << "Cache hits: " << stats.cacheHits << " of " << stats.cacheProbes
+     << "\n"
+     << "Book hits: " << stats.bookHits << "\n"
+     << "Arena allocations: " << stats.arenaAllocations << " ("
+     << stats.arenaBytes / 1024 << " KiB), " << stats.arenaBlocks
+     << " blocks from the system\n"
+     << "Generation time: " << milliseconds(stats.generationTime) << " ms\n"
+     << "Ordering time: " << milliseconds(stats.orderingTime) << " ms\n";
+  return os;
+}
@@ -0,0 +1,182 @@
+#include "self_play.hpp"
+
+#include <algorithm>  // for min, max
+#include <chrono>     // for steady_clock, duration
+#include <cstdint>    // for uint64_t
+#include <exception>  // for exception
+#include <ostream>    // for ostream, operator<<
+#include <stdexcept>  // for invalid_argument, logic_error
+#include <string>     // for string, stoul
+
+#include "game_state.hpp"           // for canonicalKey
+#include "search_context.hpp"       // for SearchContext
+#include "thread_pool.hpp"          // for ThreadPool
+#include "transposition_table.hpp"  // for TranspositionTable
+
+Policy searchPolicy(unsigned int depth) {
+  return [depth](const Game& game, const std::vector<Game::Turn>& turns,
+                 PlayerNumber player, const DicePairRoll& dices,
+                 unsigned int rollsInARow, FastRandom&) -> std::size_t {
+    if (turns.size() == 1) return 0;
+
+    // The keys of the table have the depth, so the policies of any depth
+    // share it
+    static thread_local TranspositionTable transpositionTable;
+    static thread_local const SearchContext context{&transpositionTable};
+    Game searchedGame = game;
+    searchedGame.setSearchContext(&context);
+
+    Play play =
+        searchedGame.bestPlay(player, dices, rollsInARow, depth).play;
+    // The play can come from a cache, which can keep the movements of an
+    // equivalent turn in another order, so the turn is found by its state
+    Game afterPlay = game;
+    for (const Move& move : play) afterPlay.makeMove(move);
+    const std::uint64_t playKey = canonicalKey(afterPlay.getState());
+    for (std::size_t i = 0; i < turns.size(); i++) {
+      if (canonicalKey(turns[i].finalState) == playKey) return i;
+    }
+    throw std::logic_error("The best play is not one of the turns");
+  };
+}
+
+Policy randomPolicy() {
+  return [](const Game&, const std::vector<Game::Turn>& turns, PlayerNumber,
+            const DicePairRoll&, unsigned int,
+            FastRandom& random) -> std::size_t {
+    return random.below(turns.size());
+  };
+}
+
+Policy makePolicy(const std::string& name) {
+  if (name == "random") return randomPolicy();
+
+  std::size_t parsed{0};
+  unsigned long depth{0};
+  try {
+    depth = std::stoul(name, &parsed);
+  } catch (const std::exception&) {
+  }
+  if (parsed == 0 || parsed != name.size()) {
+    throw std::invalid_argument("Unknown policy: " + name);
+  }
+  return searchPolicy(static_cast<unsigned int>(depth));
+}
+
+static PlayerNumber nextPlayerNumber(PlayerNumber player) {
+  return player % N_PLAYERS + 1;
+}
+
+GameResult playGame(const Policies& policies, std::uint64_t seed,
+                    PlayerNumber firstPlayer, unsigned int maxTurns) {
+  FastRandom random(seed);
+  Game game;
+  PlayerNumber player = firstPlayer;
+  unsigned int rollsInARow = 1;
+
+  GameResult result;
+  while (rollsInARow > 1 || result.turns < maxTurns) {
+    // A turn starts with the first roll of the player, and goes on while the
+    // player rolls doubles
+    if (rollsInARow == 1) result.turns++;
+    DicePairRoll dices = random.rollDices();
+    bool isDouble = dices.first == dices.second;
+
+    // The third double is not a decision: it takes the last touched piece
+    // to home, if it can
+    std::vector<Game::Turn> turns =
+        game.allPossibleStates(game.getPlayer(player), dices, rollsInARow);
+    bool isThirdDouble = isDouble && rollsInARow == 3;
+
+    if (!turns.empty()) {
+      std::size_t chosen = 0;
+      if (!isThirdDouble) {
+        chosen = policies[player - 1](game, turns, player, dices, rollsInARow,
+                                      random);
+      }
+      game = Game(turns[chosen].finalState);
+    }
+
+    if (game.getPlayer(player).hasWon()) {
+      result.winner = player;
+      return result;
+    }
+
+    // A double lets the player roll again, but not after the third one
+    if (isDouble && !isThirdDouble) {
+      rollsInARow++;
+    } else {
+      player = nextPlayerNumber(player);
+      rollsInARow = 1;
+    }
+  }
+
+  return result;
+}
+
+double SimulationReport::winRate(PlayerNumber player) const {
+  return games ? static_cast<double>(wins[player - 1]) / games : 0;
+}
+
+double SimulationReport::meanTurns() const {
+  return games ? static_cast<double>(totalTurns) / games : 0;
+}
+
+double SimulationReport::gamesPerSecond() const {
+  return seconds > 0 ? games / seconds : 0;
+}
+
+// Seed of every game, so close seeds give unrelated games
+static std::uint64_t gameSeed(std::uint64_t seed, std::size_t game) {
+  return FastRandom(seed ^ FastRandom(game).next()).next();
+}
+
+SimulationReport simulateGames(const Policies& policies, std::size_t nGames,
+                               std::uint64_t seed, ThreadPool* threadPool,
+                               unsigned int maxTurns) {
+  using Clock = std::chrono::steady_clock;
+  Clock::time_point start = Clock::now();
+
+  std::vector<GameResult> results(nGames);
+  auto play = [&](std::size_t i) {
+    PlayerNumber firstPlayer = static_cast<PlayerNumber>(i % N_PLAYERS) + 1;
+    results[i] = playGame(policies, gameSeed(seed, i), firstPlayer, maxTurns);
+  };
+  if (threadPool) {
+    threadPool->parallelFor(nGames, play);
+  } else {
+    for (std::size_t i = 0; i < nGames; i++) play(i);
+  }
+
+  SimulationReport report;
+  report.games = nGames;
+  report.minTurns = results.empty() ? 0 : results.front().turns;
+  for (const GameResult& result : results) {
+    if (result.winner == 0) {
+      report.unfinished++;
+    } else {
+      report.wins[result.winner - 1]++;
+    }
+    report.totalTurns += result.turns;
+    report.minTurns = std::min(report.minTurns, result.turns);
+    report.maxTurns = std::max(report.maxTurns, result.turns);
+  }
+  report.seconds =
+      std::chrono::duration<double>(Clock::now() - start).count();
+
+  return report;
+}
+
+std::ostream& operator<<(std::ostream& os, const SimulationReport& report) {
+  os << "Games: " << report.games << "\n";
+  for (PlayerNumber player = 1; player <= N_PLAYERS; player++) {
+    os << "Player " << player << " wins: " << report.wins[player - 1] << " ("
+       << 100 * report.winRate(player) << " %)\n";
+  }
+  os << "Unfinished: " << report.unfinished << "\n"
+     << "Turns: " << report.meanTurns() << " on average, from "
+     << report.minTurns << " to " << report.maxTurns << "\n"
+     << "Time: " << report.seconds << " s (" << report.gamesPerSecond()
+     << " games/s)\n";
+  return os;
+}
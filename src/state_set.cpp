@@ -0,0 +1,52 @@
+#include "state_set.hpp"
+
+#include <algorithm>  // for max
+#include <bit>        // for bit_ceil
+
+StateSet::StateSet(std::size_t capacity)
+    : slots(std::bit_ceil(std::max<std::size_t>(capacity, 2))) {}
+
+static std::size_t slotIndex(std::uint64_t key, std::size_t capacity) {
+  // Similar keys only differ on a few bits, so mix them before taking the
+  // lower ones
+  std::uint64_t hash = key * 0x9E3779B97F4A7C15ULL;
+  hash ^= hash >> 32;
+  return hash & (capacity - 1);
+}
+
+bool StateSet::insert(std::uint64_t key) {
+  // Keep at least half of the slots free so the probes are short
+  if (2 * (count + 1) > slots.size()) grow();
+
+  std::size_t i = slotIndex(key, slots.size());
+  while (slots[i].generation == generation) {
+    if (slots[i].key == key) return false;
+    i = (i + 1) & (slots.size() - 1);
+  }
+
+  slots[i] = {key, generation};
+  count++;
+  return true;
+}
+
+void StateSet::clear() {
+  count = 0;
+  generation++;
+  // After a wrap around old slots would look used again
+  if (generation == 0) {
+    for (Slot& slot : slots) slot = {};
+    generation = 1;
+  }
+}
+
+void StateSet::grow() {
+  std::vector<Slot> oldSlots(2 * slots.size());
+  oldSlots.swap(slots);
+
+  const std::uint32_t oldGeneration = generation;
+  generation = 1;
+  count = 0;
+  for (const Slot& slot : oldSlots) {
+    if (slot.generation == oldGeneration) insert(slot.key);
+  }
+}
@@ -0,0 +1,173 @@
+#include "thread_pool.hpp"
+
+#include <algorithm>  // for min
+#include <exception>  // for exception_ptr, current_exception, rethrow_ex...
+#include <iterator>   // for next
+#include <utility>    // for move
+
+struct ThreadPool::Batch {
+  const std::function<void(std::size_t)>* task;
+  std::size_t count;
+  // Nesting of the parallelFor call that created the batch
+  unsigned int level;
+
+  std::atomic<std::size_t> next{0};
+  std::atomic<std::size_t> done{0};
+
+  std::mutex errorMutex;
+  std::exception_ptr error;
+
+  // Runs the next task. Returns false if all of them have been taken.
+  bool runNext() {
+    std::size_t i = next++;
+    if (i >= count) return false;
+
+    try {
+      (*task)(i);
+    } catch (...) {
+      std::lock_guard lock(errorMutex);
+      if (!error) error = std::current_exception();
+    }
+    done++;
+    return true;
+  }
+};
+
+// Pool and queue owned by the current thread, if it is a worker
+static thread_local const ThreadPool* currentPool{nullptr};
+static thread_local std::size_t currentQueue{0};
+// Nesting of the batch the current thread is running tasks for
+static thread_local unsigned int currentLevel{0};
+
+ThreadPool::ThreadPool(unsigned int nThreads) {
+  if (nThreads == 0) nThreads = std::thread::hardware_concurrency();
+  if (nThreads == 0) nThreads = 1;
+
+  // The last queue receives the jobs pushed from outside the pool
+  for (unsigned int i = 0; i <= nThreads; i++) {
+    queues.push_back(std::make_unique<Queue>());
+  }
+
+  threads.reserve(nThreads);
+  for (unsigned int i = 0; i < nThreads; i++) {
+    threads.emplace_back(&ThreadPool::workerLoop, this, i);
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard lock(sleepMutex);
+    stopping = true;
+  }
+  wakeUp.notify_all();
+
+  for (std::thread& thread : threads) thread.join();
+}
+
+void ThreadPool::push(const Job& job) {
+  std::size_t queueIndex =
+      (currentPool == this) ? currentQueue : queues.size() - 1;
+  {
+    Queue& queue = *queues[queueIndex];
+    std::lock_guard lock(queue.mutex);
+    queue.jobs.push_back(job);
+  }
+
+  {
+    // Do not let a worker go to sleep between its check and this push
+    std::lock_guard lock(sleepMutex);
+    pendingJobs++;
+  }
+  wakeUp.notify_one();
+}
+
+bool ThreadPool::popJob(Job& job, unsigned int minLevel) {
+  const bool isWorker = currentPool == this;
+  const std::size_t nQueues = queues.size();
+  const std::size_t first = isWorker ? currentQueue : nQueues - 1;
+
+  auto isValid = [minLevel](const Job& queued) {
+    return queued->level >= minLevel;
+  };
+
+  for (std::size_t i = 0; i < nQueues; i++) {
+    Queue& queue = *queues[(first + i) % nQueues];
+    std::lock_guard lock(queue.mutex);
+
+    // Take the most recent job of my own queue,
+    // steal the oldest one from the rest
+    if (i == 0) {
+      auto itJob =
+          std::find_if(queue.jobs.rbegin(), queue.jobs.rend(), isValid);
+      if (itJob == queue.jobs.rend()) continue;
+      job = std::move(*itJob);
+      queue.jobs.erase(std::next(itJob).base());
+    } else {
+      auto itJob =
+          std::find_if(queue.jobs.begin(), queue.jobs.end(), isValid);
+      if (itJob == queue.jobs.end()) continue;
+      job = std::move(*itJob);
+      queue.jobs.erase(itJob);
+    }
+
+    pendingJobs--;
+    return true;
+  }
+
+  return false;
+}
+
+void ThreadPool::runJob(const Job& job) {
+  unsigned int previousLevel = currentLevel;
+  currentLevel = job->level;
+  while (job->runNext()) {
+  }
+  currentLevel = previousLevel;
+}
+
+void ThreadPool::workerLoop(std::size_t queueIndex) {
+  currentPool = this;
+  currentQueue = queueIndex;
+
+  while (true) {
+    Job job;
+    if (popJob(job, 0)) {
+      runJob(job);
+      continue;
+    }
+
+    std::unique_lock lock(sleepMutex);
+    wakeUp.wait(lock, [this] { return stopping || pendingJobs > 0; });
+    if (stopping) return;
+  }
+}
+
+void ThreadPool::parallelFor(std::size_t count,
+                             const std::function<void(std::size_t)>& task) {
+  if (count == 0) return;
+
+  auto batch = std::make_shared<Batch>();
+  batch->task = &task;
+  batch->count = count;
+  batch->level = currentLevel + 1;
+
+  // Let the idle workers join. There is no need of more jobs than workers.
+  std::size_t nJobs = std::min<std::size_t>(count - 1, threads.size());
+  for (std::size_t i = 0; i < nJobs; i++) push(batch);
+
+  runJob(batch);
+
+  // Wait for the tasks taken by other threads.
+  // Meanwhile, only help with jobs nested deeper than this one, so the stack
+  // of this thread cannot grow beyond the nesting of the calls.
+  while (batch->done < count) {
+    Job job;
+    if (popJob(job, batch->level + 1)) {
+      runJob(job);
+    } else {
+      std::this_thread::yield();
+    }
+  }
+
+  if (batch->error) std::rethrow_exception(batch->error);
+}
@@ -0,0 +1,143 @@
+#include "transposition_table.hpp"
+
+#include <algorithm>  // for max
+#include <bit>        // for bit_floor
+#include <cstdint>    // for uint64_t
+
+#include "game_state.hpp"  // for canonicalKey, mirrorState, mirrorPlayer
+#include "table.hpp"       // for Position, PlayerNumber
+
+static std::uint64_t packContext(const Game::Turn::FinalState& state,
+                                 PlayerNumber player, PlayerNumber nextPlayer,
+                                 unsigned int depth, unsigned int rollsInARow,
+                                 const DicePairRoll& dices) {
+  std::uint64_t packed{0};
+  for (Position lastTouched : state.lastTouched) {
+    packed = (packed << 8) | lastTouched;
+  }
+  packed = (packed << 8) | player;
+  packed = (packed << 8) | nextPlayer;
+  packed = (packed << 8) | rollsInARow;
+  packed = (packed << 8) | depth;
+  packed = (packed << 8) | dices.first;
+  packed = (packed << 8) | dices.second;
+
+  return packed;
+}
+
+TranspositionTable::Key TranspositionTable::chanceKey(
+    const Game::Turn::FinalState& state, PlayerNumber currentPlayer,
+    PlayerNumber nextPlayer, unsigned int depth, unsigned int rollsInARow) {
+  if (isMirrored(currentPlayer)) {
+    return chanceKey(mirrorState(state), mirrorPlayer(currentPlayer),
+                     mirrorPlayer(nextPlayer), depth, rollsInARow);
+  }
+
+  // Dices are not known yet, use an impossible roll
+  return {canonicalKey(state), packContext(state, currentPlayer, nextPlayer,
+                                           depth, rollsInARow, {0, 0})};
+}
+
+TranspositionTable::Key TranspositionTable::decisionKey(
+    const Game::Turn::FinalState& state, PlayerNumber player,
+    const DicePairRoll& dices, unsigned int depth, unsigned int rollsInARow) {
+  if (isMirrored(player)) {
+    return decisionKey(mirrorState(state), mirrorPlayer(player), dices, depth,
+                       rollsInARow);
+  }
+
+  // The player who decides is stored as next player too, so decision keys
+  // never collide with chance keys
+  return {canonicalKey(state),
+          packContext(state, player, player, depth, rollsInARow, dices) |
+              (std::uint64_t{1} << 63)};
+}
+
+TranspositionTable::TranspositionTable(std::size_t capacity)
+    : entries(std::bit_floor(std::max<std::size_t>(capacity, 2))) {}
+
+std::size_t TranspositionTable::bucket(const Key& key) const {
+  // Mix both words so that similar positions go to distant buckets
+  std::uint64_t hash = key.pieces * 0x9E3779B97F4A7C15ULL;
+  hash ^= key.context + 0x632BE59BD9B4E019ULL + (hash << 6) + (hash >> 2);
+  hash ^= hash >> 31;
+  hash *= 0xBF58476D1CE4E5B9ULL;
+  hash ^= hash >> 29;
+
+  // Buckets are made of two consecutive entries
+  return hash & (entries.size() - 2);
+}
+
+std::mutex& TranspositionTable::lock(std::size_t bucket) {
+  return locks[(bucket / 2) % locks.size()];
+}
+
+std::optional<ScoredPlay> TranspositionTable::probe(const Key& key) {
+  return probe(key, {});
+}
+
+// Checks whether the stored score is useful for a search with this window
+static bool isUsable(double score, TranspositionTable::Bound bound,
+                     const SearchWindow& window) {
+  switch (bound) {
+    case TranspositionTable::Bound::LOWER:
+      return score >= window.beta;
+    case TranspositionTable::Bound::UPPER:
+      return score <= window.alpha;
+    default:
+      return true;
+  }
+}
+
+std::optional<ScoredPlay> TranspositionTable::probe(
+    const Key& key, const SearchWindow& window) {
+  nProbes++;
+
+  std::size_t first = bucket(key);
+  std::lock_guard guard(lock(first));
+  for (std::size_t i = first; i < first + 2; i++) {
+    const Entry& entry = entries[i];
+    if (entry.used && entry.key == key) {
+      if (!isUsable(entry.result.score, entry.bound, window)) break;
+      nHits++;
+      return entry.result;
+    }
+  }
+
+  return std::nullopt;
+}
+
+void TranspositionTable::store(const Key& key, unsigned int depth,
+                               const ScoredPlay& result, Bound bound) {
+  std::size_t first = bucket(key);
+  std::lock_guard guard(lock(first));
+  Entry& deepest = entries[first];
+  Entry& newest = entries[first + 1];
+
+  // Keep the deepest search in the first entry, and the most recent one in
+  // the second entry
+  Entry* target{&newest};
+  if (newest.used && newest.key == key) {
+    // Update the entry I already had
+    target = &newest;
+  } else if (!deepest.used || deepest.key == key) {
+    target = &deepest;
+  } else if (depth >= deepest.depth) {
+    // The replaced deep entry is still the most recent of the rest
+    if (!newest.used) usedEntries++;
+    newest = deepest;
+    target = &deepest;
+  }
+
+  if (!target->used) usedEntries++;
+  *target = {key, result, bound, static_cast<std::uint8_t>(depth), true};
+}
+
+void TranspositionTable::clear() {
+  for (std::mutex& bucketLock : locks) bucketLock.lock();
+  for (Entry& entry : entries) entry = {};
+  for (std::mutex& bucketLock : locks) bucketLock.unlock();
+  usedEntries = 0;
+  nHits = 0;
+  nProbes = 0;
+}
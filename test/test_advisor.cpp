@@ -0,0 +1,68 @@
+#include <gtest/gtest.h>  // for Test, SuiteApiResolver, TestInfo (ptr only)
+
+#include <cstddef>  // for size_t
+#include <vector>   // for vector
+
+#include "advisor.hpp"  // for Advisor, Query
+#include "dices.hpp"    // for DicePairRoll
+#include "game.hpp"     // for Game, ScoredPlay, Move
+#include "player.hpp"   // for Player
+#include "table.hpp"    // for GOAL, HOME
+
+static GameState makeState(const Game::Players& players) {
+  return Game(players).getState();
+}
+
+static void comparePlays(const ScoredPlay& play, const ScoredPlay& expected) {
+  ASSERT_EQ(play.score, expected.score);
+  ASSERT_EQ(play.play.size(), expected.play.size());
+  for (std::size_t i = 0; i < play.play.size(); i++) {
+    ASSERT_EQ(play.play[i].player, expected.play[i].player);
+    ASSERT_EQ(play.play[i].origin, expected.play[i].origin);
+    ASSERT_EQ(play.play[i].dest, expected.play[i].dest);
+  }
+}
+
+TEST(TestAdvisor, ResultsInQueryOrder) {
+  GameState opening = makeState(
+      {Player({1, {HOME, HOME, 5, 6}}), Player({2, {8, 20, 21, HOME}})});
+  GameState endGame = makeState({Player({1, {GOAL, GOAL, 60, 104}}),
+                                 Player({2, {GOAL, 28, 103, 24}})});
+
+  std::vector<Query> queries{{opening, 1, {5, 2}},
+                             {endGame, 1, {5, 2}},
+                             {endGame, 2, {4, 4}},
+                             {opening, 2, {6, 1}},
+                             {endGame, 1, {5, 2}}};
+
+  Advisor advisor(1, 2);
+  std::vector<ScoredPlay> plays = advisor.bestPlays(queries);
+
+  ASSERT_EQ(plays.size(), queries.size());
+  for (std::size_t i = 0; i < queries.size(); i++) {
+    const Query& query = queries[i];
+    ScoredPlay expected =
+        Game(query.state).bestPlay(query.player, query.roll, 1, 1);
+    comparePlays(plays[i], expected);
+  }
+}
+
+TEST(TestAdvisor, CacheSharedBetweenCalls) {
+  GameState endGame = makeState({Player({1, {GOAL, GOAL, 60, 104}}),
+                                 Player({2, {GOAL, 28, 103, 24}})});
+  Query query{endGame, 1, {5, 2}};
+
+  Advisor advisor(2, 1);
+  ScoredPlay first = advisor.bestPlay(query);
+  std::size_t hits = advisor.getTranspositionTable().hits();
+
+  // The second time the result is already in the cache
+  ScoredPlay second = advisor.bestPlay(query);
+  ASSERT_EQ(advisor.getTranspositionTable().hits(), hits + 1);
+  comparePlays(second, first);
+}
+
+TEST(TestAdvisor, EmptyBatch) {
+  Advisor advisor;
+  ASSERT_TRUE(advisor.bestPlays({}).empty());
+}
@@ -0,0 +1,49 @@
+#include <gtest/gtest.h>  // for Test, SuiteApiResolver, TestInfo (ptr only)
+
+#include <cstdint>          // for uintptr_t
+#include <memory_resource>  // for vector
+
+#include "arena.hpp"  // for Arena
+
+TEST(TestArena, ScopeGivesTheMemoryBack) {
+  Arena arena(1024);
+  void* first{nullptr};
+  {
+    Arena::Scope scope(arena);
+    ASSERT_TRUE(scope.isOutermost());
+    first = arena.allocate(100);
+    ASSERT_EQ(arena.used(), 100);
+
+    {
+      Arena::Scope nested(arena);
+      ASSERT_FALSE(nested.isOutermost());
+      std::pmr::vector<int> values(&arena);
+      values.reserve(50);
+      for (int i = 0; i < 50; i++) values.push_back(i);
+      ASSERT_EQ(values[49], 49);
+    }
+    ASSERT_EQ(arena.used(), 100);
+    ASSERT_EQ(scope.stats().allocations, 2);
+  }
+  ASSERT_EQ(arena.used(), 0);
+
+  // The same memory is served again, without asking the system for more
+  Arena::Scope scope(arena);
+  ASSERT_EQ(arena.allocate(100), first);
+  ASSERT_EQ(arena.stats().blocks, 1);
+}
+
+TEST(TestArena, BiggerThanTheBlocks) {
+  Arena arena(64);
+  Arena::Scope scope(arena);
+  ASSERT_NE(arena.allocate(32), nullptr);
+  void* big = arena.allocate(1000, 64);
+  ASSERT_EQ(reinterpret_cast<std::uintptr_t>(big) % 64, 0);
+  ASSERT_EQ(arena.stats().blocks, 2);
+  ASSERT_GE(arena.capacity(), 1064);
+
+  // The top is on the big block now, and the rest of it is too small
+  void* next = arena.allocate(100);
+  ASSERT_EQ(arena.stats().blocks, 3);
+  ASSERT_NE(next, big);
+}
@@ -0,0 +1,83 @@
+#include <gtest/gtest.h>  // for Test, SuiteApiResolver, TestInfo (ptr only)
+
+#include "board.hpp"  // for SquareMask, Board
+#include "table.hpp"  // for HOME, GOAL, totalPositions, firstHallway
+
+TEST(TestBoard, MaskIgnoresNotCommonPositions) {
+  SquareMask mask{HOME, firstHallway, GOAL};
+
+  ASSERT_TRUE(mask.none());
+  ASSERT_FALSE(mask.test(HOME));
+  ASSERT_FALSE(mask.test(GOAL));
+}
+
+TEST(TestBoard, MaskRange) {
+  ASSERT_EQ(SquareMask::range(1, totalPositions).count(), totalPositions);
+  ASSERT_EQ(SquareMask::range(60, 70), SquareMask::range(60, totalPositions));
+  ASSERT_TRUE(SquareMask::range(10, 5).none());
+
+  // Range in both words
+  SquareMask range = SquareMask::range(63, 66);
+  ASSERT_EQ(range, (SquareMask{63, 64, 65, 66}));
+
+  // Range only in the second word
+  ASSERT_EQ(SquareMask::range(65, 65), SquareMask{65});
+  ASSERT_EQ(SquareMask::range(64, 64), SquareMask{64});
+}
+
+TEST(TestBoard, BarriersAfterMovements) {
+  Board board;
+  board.add(1, 7);
+  ASSERT_TRUE(board.barriers().none());
+  ASSERT_EQ(board.occupied(), SquareMask{7});
+
+  board.add(1, 7);
+  ASSERT_EQ(board.barriers(), SquareMask{7});
+
+  board.move(1, 7, 68);
+  ASSERT_TRUE(board.barriers().none());
+  ASSERT_EQ(board.occupied(), (SquareMask{7, 68}));
+
+  board.move(1, 68, GOAL);
+  ASSERT_EQ(board.occupied(), SquareMask{7});
+}
+
+TEST(TestBoard, ThreePiecesOnPosition) {
+  // A piece gets out of home to a barrier
+  Board board;
+  board.add(2, 35);
+  board.add(1, 35);
+  board.add(2, 35);
+  ASSERT_EQ(board.count(35), 3);
+
+  // Then, one of the pieces is eaten, the barrier remains
+  board.remove(1, 35);
+  ASSERT_EQ(board.barriers(), SquareMask{35});
+
+  board.remove(2, 35);
+  ASSERT_TRUE(board.barriers().none());
+  ASSERT_EQ(board.occupied(), SquareMask{35});
+}
+
+TEST(TestBoard, PiecesOfEveryPlayer) {
+  Board board;
+  for (int i = 0; i < 3; i++) board.add(1, HOME);
+  board.add(1, 20);
+  board.add(2, 20);
+  board.add(2, 40);
+  board.add(2, 40);
+
+  // A barrier can be made of pieces of different players
+  ASSERT_EQ(board.barriers(), (SquareMask{20, 40}));
+  ASSERT_EQ(board.occupied(1), SquareMask{20});
+  ASSERT_EQ(board.occupied(2), (SquareMask{20, 40}));
+  ASSERT_EQ(board.count(1, 20), 1);
+  ASSERT_EQ(board.count(2, 40), 2);
+  ASSERT_EQ(board.count(1, 40), 0);
+
+  ASSERT_EQ(board.count(1, HOME), 3);
+  ASSERT_EQ(board.count(2, HOME), 0);
+  board.move(1, HOME, 1);
+  ASSERT_EQ(board.count(1, HOME), 2);
+  ASSERT_EQ(board.occupied(1), (SquareMask{1, 20}));
+}
@@ -0,0 +1,36 @@
+#include <gtest/gtest.h>  // for Test, SuiteApiResolver, TestInfo (ptr only)
+
+#include <thread>  // for thread
+
+#include "bounded_queue.hpp"  // for BoundedQueue
+
+TEST(TestBoundedQueue, KeepsTheOrder) {
+  BoundedQueue<int> queue(2);
+
+  // The producer has to wait for the consumer to make room
+  std::thread producer([&] {
+    for (int i = 0; i < 100; i++) queue.push(i);
+    queue.close();
+  });
+
+  int expected = 0;
+  while (auto item = queue.pop()) ASSERT_EQ(*item, expected++);
+  producer.join();
+
+  ASSERT_EQ(expected, 100);
+}
+
+TEST(TestBoundedQueue, TryPopDoesNotWait) {
+  BoundedQueue<int> queue(2);
+  ASSERT_FALSE(queue.tryPop());
+
+  queue.push(1);
+  ASSERT_EQ(queue.tryPop(), 1);
+  ASSERT_FALSE(queue.tryPop());
+
+  // A closed queue gives the items left
+  queue.push(2);
+  queue.close();
+  ASSERT_EQ(queue.pop(), 2);
+  ASSERT_FALSE(queue.pop());
+}
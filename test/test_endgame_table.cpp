@@ -0,0 +1,103 @@
+#include <gtest/gtest.h>  // for Test, SuiteApiResolver, TestInfo (ptr only)
+
+#include <filesystem>  // for temp_directory_path, path, remove
+#include <fstream>     // for ofstream
+#include <string>      // for string
+#include <vector>      // for vector
+
+#include "dices.hpp"          // for averageDiceRoll, getUnorderedRollsProb
+#include "endgame_table.hpp"  // for EndgameTable
+#include "game.hpp"           // for Game
+#include "game_state.hpp"     // for GameState
+#include "table.hpp"          // for GOAL, firstHallway
+
+TEST(TestEndgameTable, Covers) {
+  ASSERT_TRUE(EndgameTable::covers({GOAL, firstHallway, GOAL - 1, GOAL}));
+  ASSERT_FALSE(EndgameTable::covers({GOAL, firstHallway, 64, GOAL}));
+  ASSERT_FALSE(EndgameTable::covers({GOAL, GOAL, GOAL, GOAL}));
+}
+
+TEST(TestEndgameTable, PieceNextToGoal) {
+  EndgameTable table = EndgameTable::solve();
+  // It only gets to goal with a die of 1. The third doubles do not move it,
+  // so it needs slightly more rolls.
+  double rolls = table.at({GOAL - 1, GOAL, GOAL, GOAL}).punctuation /
+                 averageDiceRoll;
+  ASSERT_GT(rolls, 36.0 / 11);
+  ASSERT_NEAR(rolls, 36.0 / 11, 0.01);
+}
+
+TEST(TestEndgameTable, TurnsDoNotGoBeyondTheReachable) {
+  EndgameTable table = EndgameTable::solve();
+  constexpr UnorderedRollsProb rolls{getUnorderedRollsProb()};
+  std::vector<Game::Turn> turns;
+
+  // Both hallways have the same positions, so it is the same table for both
+  GameState state;
+  state.pieces = {{{GOAL - 7, GOAL - 3, GOAL - 3, GOAL}, {101, 102, 103, 104}}};
+  state.lastTouched = {GOAL - 7, 101};
+  Game game(state);
+  for (PlayerNumber player = 1; player <= 2; player++) {
+    const EndgameTable::Entry& entry = table.at(state.getPieces(player));
+    for (const auto& [roll, probability] : rolls) {
+      game.generateTurns(player, roll, 1, turns);
+      for (const Game::Turn& turn : turns) {
+        const GameState::Pieces& pieces = turn.finalState.getPieces(player);
+        if (!EndgameTable::covers(pieces)) continue;
+        double punctuation = table.at(pieces).punctuation;
+        ASSERT_LE(punctuation, entry.maxReachablePunctuation);
+      }
+    }
+  }
+}
+
+TEST(TestEndgameTable, WinProbability) {
+  EndgameTable table = EndgameTable::solve();
+  constexpr GameState::Pieces farthest{101, 101, 101, 101};
+  constexpr GameState::Pieces nextToGoal{GOAL - 1, GOAL, GOAL, GOAL};
+
+  // With the same pieces, rolling first is an advantage, but not a sure win
+  double first = table.winProbability(farthest, 1, farthest);
+  ASSERT_GT(first, 0.5);
+  ASSERT_LT(first, 1.0);
+  // The doubles already rolled make the turn end sooner
+  ASSERT_LT(table.winProbability(farthest, 3, farthest), first);
+
+  // A single piece next to the goal needs a die of 1, while the other player
+  // needs many turns to take all its pieces in
+  ASSERT_GT(table.winProbability(nextToGoal, 1, farthest), 0.9);
+  // Rolling first never makes the chances worse
+  ASSERT_GT(table.winProbability(nextToGoal, 1, farthest) +
+                table.winProbability(farthest, 1, nextToGoal),
+            1.0);
+
+  // A player that has taken all its pieces in has already won
+  constexpr GameState::Pieces allInGoal{GOAL, GOAL, GOAL, GOAL};
+  ASSERT_EQ(table.winProbability(allInGoal, 1, farthest), 1.0);
+  ASSERT_EQ(table.winProbability(farthest, 1, allInGoal), 0.0);
+}
+
+TEST(TestEndgameTable, SaveAndLoad) {
+  std::filesystem::path path =
+      std::filesystem::temp_directory_path() / "test_endgame_table.bin";
+  EndgameTable table = EndgameTable::solve();
+  table.save(path.string());
+  EndgameTable loaded = EndgameTable::load(path.string());
+
+  for (GameState::Pieces pieces :
+       {GameState::Pieces{GOAL - 1, GOAL, GOAL, GOAL},
+        GameState::Pieces{101, 102, 105, 107},
+        GameState::Pieces{101, 101, 101, 101}}) {
+    ASSERT_EQ(loaded.at(pieces).punctuation, table.at(pieces).punctuation);
+    ASSERT_EQ(loaded.at(pieces).maxReachablePunctuation,
+              table.at(pieces).maxReachablePunctuation);
+    ASSERT_EQ(loaded.winProbability(pieces, 2, {101, 103, 103, 104}),
+              table.winProbability(pieces, 2, {101, 103, 103, 104}));
+  }
+  ASSERT_EQ(loaded.maxPunctuation(), table.maxPunctuation());
+
+  std::ofstream(path) << "Not a table";
+  ASSERT_THROW(EndgameTable::load(path.string()), EndgameTable::InvalidFile);
+  std::filesystem::remove(path);
+  ASSERT_THROW(EndgameTable::load(path.string()), EndgameTable::InvalidFile);
+}
@@ -2,15 +2,25 @@
 
 #include <algorithm>  // for count
 #include <array>      // for array
+#include <cmath>      // for abs
+#include <cstddef>    // for size_t
+#include <cstdint>    // for uint64_t
 #include <memory>     // for allocator_traits<>::value_type
-#include <set>        // for operator==, set
 #include <string>     // for allocator, string
 #include <vector>     // for vector
 
-#include "dices.hpp"   // for DicePairRoll
-#include "game.hpp"    // for Play, Game, Game::Players, Move, ScoredPlay
-#include "player.hpp"  // for Player
-#include "table.hpp"   // for GOAL, HOME, getPlayerInitialPosition, Position
+#include "board.hpp"           // for SquareMask
+#include "dices.hpp"           // for DicePairRoll
+#include "endgame_table.hpp"   // for EndgameTable
+#include "fast_random.hpp"     // for FastRandom
+#include "game.hpp"            // for Play, Game, Game::Players, Move, Sco...
+#include "player.hpp"          // for Player
+#include "search_budget.hpp"   // for SearchBudget
+#include "search_context.hpp"  // for SearchContext
+#include "search_stats.hpp"    // for SearchStats
+#include "table.hpp"           // for GOAL, HOME, getPlayerInitialPosition, ...
+#include "thread_pool.hpp"     // for ThreadPool
+#include "zobrist.hpp"         // for zobristHash
 
 static void compareMove(const Move& bestMove, const Move& expectedBestMove) {
   ASSERT_EQ(bestMove.player, expectedBestMove.player);
@@ -314,7 +324,7 @@ TEST(TestGame, LoadBarrierSamePlayer) {
 
   Game game(players);
 
-  ASSERT_TRUE(game.barriers == std::set<Position>{62});
+  ASSERT_TRUE(game.board.barriers() == SquareMask{62});
 }
 
 TEST(TestGame, LoadBarrierDifferentPlayers) {
@@ -323,7 +333,7 @@ TEST(TestGame, LoadBarrierDifferentPlayers) {
 
   Game game(players);
 
-  ASSERT_TRUE(game.barriers == std::set<Position>{1});
+  ASSERT_TRUE(game.board.barriers() == SquareMask{1});
 }
 
 TEST(TestGame, NotBarrierOnHallway) {
@@ -334,7 +344,7 @@ TEST(TestGame, NotBarrierOnHallway) {
 
   Game game(players);
 
-  ASSERT_TRUE(game.barriers == std::set<Position>{62});
+  ASSERT_TRUE(game.board.barriers() == SquareMask{62});
 }
 
 TEST(TestGame, DontCrossBarrier) {
@@ -413,7 +423,7 @@ TEST(TestGame, CreateBarrierAfterMove) {
     game.movePiece(move.player, move.origin, advance);
   }
 
-  ASSERT_TRUE(game.barriers == std::set<Position>{8});
+  ASSERT_TRUE(game.board.barriers() == SquareMask{8});
 }
 
 TEST(TestGame, CannotMoveBecauseBarrier) {
@@ -633,6 +643,55 @@ TEST(TestGame, LastTouchedRecord) {
   ASSERT_EQ(lastTouched, 13);
 }
 
+TEST(TestGame, GoBackHomeOnThirdDoubleSecondPlayer) {
+  Game::Players players{Player({1, {HOME, HOME, HOME, HOME}}),
+                        Player({2, {40, 20, HOME, HOME}})};
+
+  Game game(players);
+  game.setLastTouched(2, 20);
+  std::vector<Game::Turn> states =
+      game.allPossibleStates(game.getPlayer(2), {2, 2}, 3);
+
+  ASSERT_EQ(states.size(), 1);
+  comparePlays(states.front().movements, {{2, 20, HOME}});
+}
+
+TEST(TestGame, PlayersFromState) {
+  Game::Players players{Player({1, {HOME, 7, 102, GOAL}}),
+                        Player({2, {35, 35, GOAL, HOME}})};
+
+  Game game(players);
+  game.movePiece(1, 7, 6);
+
+  // The players are built back from the state of the game
+  const Player player1 = game.getPlayer(1);
+  ASSERT_EQ(player1.pieces, (Player::Pieces{HOME, 13, 102, GOAL}));
+  ASSERT_EQ(game.getPlayer(2).pieces, players[1].pieces);
+  ASSERT_EQ(game.getNextPlayer(1).playerNumber, 2);
+
+  // The state is the same no matter how it is reached
+  Game::Players movedPlayers{Player({1, {HOME, 13, 102, GOAL}}), players[1]};
+  Game movedGame(movedPlayers);
+  movedGame.setLastTouched(1, 13);
+  ASSERT_EQ(game.getState(), movedGame.getState());
+  ASSERT_EQ(game.board, movedGame.board);
+}
+
+TEST(TestGame, PunctuationAfterMovements) {
+  Game::Players players{Player({1, {HOME, 7, 102, GOAL}}),
+                        Player({2, {35, 9, GOAL, HOME}})};
+
+  Game game(players);
+  game.movePiece(1, 7, 2);
+  game.pieceEaten(2, 9);
+  game.movePiece(1, 102, 6);
+
+  for (PlayerNumber player = 1; player <= 2; player++) {
+    ASSERT_EQ(game.getPunctuation(player),
+              game.getPlayer(player).punctuation());
+  }
+}
+
 TEST(TestGame, LastTouchedInTurn) {
   // Place pieces of 1 in positions that cannot go back home
   Game::Players players{Player({1, {HOME, 7, HOME, GOAL}}),
@@ -725,4 +784,319 @@ TEST(TestGame, SameOnGoOutAndMove) {
 
   std::vector<Game::Turn> states = game.allPossibleStates(mover, roll);
   ASSERT_EQ(states.size(), 1);
-}
\ No newline at end of file
+}
+
+TEST(TestGame, GenerateTurnsReusesTheBuffer) {
+  Game::Players players{Player({1, {1, 34, 11, 7}}),
+                        Player({2, {GOAL - 3, 47, 35, 41}})};
+  Game game(players);
+
+  // The buffer already has turns from another roll
+  std::vector<Game::Turn> turns;
+  game.generateTurns(1, {6, 6}, 1, turns);
+  ASSERT_FALSE(turns.empty());
+
+  for (DicePairRoll roll : {DicePairRoll{1, 2}, DicePairRoll{5, 5}}) {
+    game.generateTurns(1, roll, 1, turns);
+    std::vector<Game::Turn> expected =
+        game.allPossibleStates(game.getPlayer(1), roll);
+
+    ASSERT_EQ(turns.size(), expected.size());
+    for (std::size_t i = 0; i < turns.size(); i++) {
+      ASSERT_EQ(turns[i].finalState, expected[i].finalState);
+      comparePlays(turns[i].movements, expected[i].movements);
+    }
+  }
+}
+
+TEST(TestGame, ParallelSearchSameAsSequential) {
+  Game::Players players{Player({1, {1, 34, 11, 7}}),
+                        Player({2, {GOAL - 3, 47, 35, 41}})};
+
+  ThreadPool threadPool(4);
+  SearchContext context;
+  context.threadPool = &threadPool;
+
+  for (DicePairRoll roll : {DicePairRoll{1, 2}, DicePairRoll{3, 3}}) {
+    Game game(players);
+    ScoredPlay expected = game.bestPlay(1, roll, 1, 1);
+
+    game.setSearchContext(&context);
+    ScoredPlay parallel = game.bestPlay(1, roll, 1, 1);
+
+    comparePlays(parallel.play, expected.play);
+    // The scores are added in the same order
+    ASSERT_EQ(parallel.score, expected.score);
+  }
+}
+
+TEST(TestGame, PrunedSearchSameAsExhaustive) {
+  struct Search {
+    Game::Players players;
+    unsigned int depth;
+  };
+  // Only positions with few movements are searched deeper
+  std::vector<Search> searches{
+      {{Player({1, {1, 34, 11, 7}}), Player({2, {GOAL - 3, 47, 35, 41}})}, 1},
+      {{Player({1, {HOME, HOME, 5, 6}}), Player({2, {8, 20, 21, HOME}})}, 1},
+      {{Player({1, {GOAL, GOAL, 60, 104}}), Player({2, {GOAL, 28, 103, 24}})},
+       2}};
+
+  SearchContext exhaustive;
+  exhaustive.pruning = false;
+
+  for (const Search& search : searches) {
+    for (DicePairRoll roll : {DicePairRoll{5, 2}, DicePairRoll{4, 4}}) {
+      Game game(search.players);
+      ScoredPlay pruned = game.bestPlay(1, roll, 1, search.depth);
+
+      game.setSearchContext(&exhaustive);
+      ScoredPlay expected = game.bestPlay(1, roll, 1, search.depth);
+
+      comparePlays(pruned.play, expected.play);
+      ASSERT_EQ(pruned.score, expected.score);
+    }
+  }
+}
+
+TEST(TestGame, EndgamePrunedSearchSameAsExhaustive) {
+  EndgameTable endgameTable = EndgameTable::solve();
+  // The players get into the table with their next movements
+  std::vector<Game::Players> searches{
+      {Player({1, {GOAL, GOAL, 60, 104}}), Player({2, {GOAL, 103, 105, 106}})},
+      {Player({1, {62, 103, GOAL, GOAL}}), Player({2, {101, 24, GOAL, 107}})}};
+
+  SearchContext pruning;
+  pruning.endgameTable = &endgameTable;
+  SearchContext exhaustive = pruning;
+  exhaustive.pruning = false;
+
+  for (const Game::Players& players : searches) {
+    for (DicePairRoll roll : {DicePairRoll{5, 2}, DicePairRoll{4, 4}}) {
+      Game game(players);
+      game.setSearchContext(&pruning);
+      ScoredPlay pruned = game.bestPlay(1, roll, 1, 2);
+
+      game.setSearchContext(&exhaustive);
+      ScoredPlay expected = game.bestPlay(1, roll, 1, 2);
+
+      comparePlays(pruned.play, expected.play);
+      ASSERT_EQ(pruned.score, expected.score);
+    }
+  }
+}
+
+TEST(TestGame, SolvedEndgameIsNotSearched) {
+  EndgameTable endgameTable = EndgameTable::solve();
+  Game game(Game::Players{Player({1, {GOAL, 101, 105, GOAL}}),
+                          Player({2, {107, 103, GOAL, 106}})});
+  SearchContext context;
+  context.endgameTable = &endgameTable;
+  game.setSearchContext(&context);
+
+  // The leaves of the searches that do not get to solved endgames use the
+  // exact punctuations of the races
+  double exact = endgameTable.at(game.getState().getPieces(1)).punctuation -
+                 endgameTable.at(game.getState().getPieces(2)).punctuation;
+  ASSERT_EQ(game.nonRecursiveEvaluateState(1), exact);
+
+  // Player 2 rolls next, so the score of player 1 comes from the chances of
+  // player 2 winning the race, on the scale of the punctuations of the table
+  double secondWins = endgameTable.winProbability(
+      game.getState().getPieces(2), 1, game.getState().getPieces(1));
+  double score = game.evaluateState(1, 2, 3, 1);
+  ASSERT_DOUBLE_EQ(score,
+                   endgameTable.maxPunctuation() * (2 * secondWins - 1));
+  ASSERT_LE(std::abs(score), endgameTable.maxPunctuation());
+}
+
+TEST(TestGame, BudgetedSearchSameAsFixedDepth) {
+  Game::Players players{Player({1, {GOAL, GOAL, 60, 104}}),
+                        Player({2, {GOAL, 28, 103, 24}})};
+  DicePairRoll roll{5, 2};
+
+  Game game(players);
+  SearchBudget budget(SearchBudget::Clock::duration::zero(), 0, 2);
+  AnytimePlay anytime = game.bestPlayInBudget(1, roll, budget);
+  ScoredPlay expected = game.bestPlay(1, roll, 1, 2);
+
+  ASSERT_EQ(anytime.depth, 2);
+  comparePlays(anytime.scoredPlay.play, expected.play);
+  ASSERT_EQ(anytime.scoredPlay.score, expected.score);
+}
+
+TEST(TestGame, BudgetStopsTheSearch) {
+  Game::Players players{Player({1, {1, 34, 11, 7}}),
+                        Player({2, {GOAL - 3, 47, 35, 41}})};
+  DicePairRoll roll{1, 2};
+
+  Game game(players);
+  SearchBudget budget(SearchBudget::Clock::duration::zero(), 100);
+  AnytimePlay anytime = game.bestPlayInBudget(1, roll, budget);
+
+  // There is always a play, even if only the first search was completed
+  ASSERT_TRUE(budget.isExhausted());
+  ASSERT_LT(anytime.depth, 2);
+  ASSERT_EQ(anytime.scoredPlay.play.size(), 2);
+  comparePlays(anytime.scoredPlay.play,
+               game.bestPlay(1, roll, 1, anytime.depth).play);
+}
+
+TEST(TestGame, BudgetNotSpentWithoutADecision) {
+  Game::Players players{Player({1, {HOME, HOME, HOME, HOME}}),
+                        Player({2, {GOAL, 28, 103, 24}})};
+  DicePairRoll roll{1, 2};
+
+  Game game(players);
+  SearchBudget budget(SearchBudget::Clock::duration::zero(), 1);
+  AnytimePlay anytime = game.bestPlayInBudget(1, roll, budget);
+
+  // No piece can leave home, so the play is scored without searching
+  ASSERT_FALSE(budget.isExhausted());
+  ASSERT_EQ(anytime.depth, 0);
+  ASSERT_TRUE(anytime.scoredPlay.play.empty());
+  ASSERT_EQ(anytime.scoredPlay.score, game.bestPlay(1, roll, 1, 0).score);
+}
+
+TEST(TestGame, ThirdDoubleIsSearched) {
+  GameState state;
+  state.pieces = {{{20, 30, HOME, HOME}, {40, 50, HOME, HOME}}};
+  state.lastTouched = {30, 50};
+  Game game(state);
+  DicePairRoll roll{3, 3};
+
+  // The third double sends the last piece moved home, whichever way the
+  // decision is searched
+  ScoredPlay thirdDouble = game.bestPlay(1, roll, 3, 1);
+  ASSERT_EQ(thirdDouble.play.size(), 1);
+  ASSERT_EQ(thirdDouble.play[0].origin, 30);
+  ASSERT_EQ(thirdDouble.play[0].dest, HOME);
+  SearchBudget budget(SearchBudget::Clock::duration::zero(), 0, 1);
+  ASSERT_EQ(game.bestPlayInBudget(1, roll, budget, 3).scoredPlay.score,
+            game.bestPlay(1, roll, 3, 0).score);
+
+  // The first double moves the pieces
+  ASSERT_NE(game.bestPlay(1, roll, 1, 1).play[0].dest, HOME);
+}
+
+TEST(TestGame, SearchStatsCountTheSearch) {
+  Game::Players players{Player({1, {GOAL, GOAL, 60, 104}}),
+                        Player({2, {GOAL, 28, 103, 24}})};
+  DicePairRoll roll{5, 2};
+
+  // The budget counts the nodes too
+  SearchBudget budget(SearchBudget::Clock::duration::zero());
+  SearchStats stats;
+  SearchContext context;
+  context.pruning = false;
+  context.budget = &budget;
+  context.stats = &stats;
+
+  Game game(players);
+  game.setSearchContext(&context);
+  std::size_t nTurns = game.allPossibleStates(game.getPlayer(1), roll).size();
+  stats.reset();
+  game.bestPlay(1, roll, 1, 1);
+
+  if constexpr (SearchStats::ENABLED) {
+    ASSERT_EQ(stats.nodes(), budget.spentNodes());
+    ASSERT_EQ(stats.nodesPerDepth[1], 1);
+    // Every turn is evaluated with every roll
+    ASSERT_EQ(stats.nodesPerDepth[0], nTurns * getUnorderedRollsProb().size());
+    ASSERT_GE(stats.generatedTurns, nTurns);
+    ASSERT_GT(stats.leafEvaluations, 0);
+    // There is no cache
+    ASSERT_EQ(stats.cacheProbes, 0);
+  } else {
+    // Nothing is collected
+    ASSERT_EQ(stats.nodes(), 0);
+    ASSERT_EQ(stats.generatedTurns, 0);
+  }
+}
+
+TEST(TestGame, HashAfterMovements) {
+  Game game({Player({1, {HOME, 7, 20, 20}}), Player({2, {21, HOME, 40, 50}})});
+  Game reordered(
+      {Player({1, {HOME, 20, 7, 20}}), Player({2, {21, 50, 40, HOME}})});
+  ASSERT_EQ(game.getHash(), reordered.getHash());
+
+  // Moving and eating keeps the hash as if it was computed from the state
+  game.movePiece(1, 20, 1);
+  ASSERT_EQ(game.getHash(), Game(game.getState()).getHash());
+  ASSERT_NE(game.getHash(), reordered.getHash());
+  game.pieceEaten(2, 21);
+  ASSERT_EQ(game.getHash(), Game(game.getState()).getHash());
+
+  // Only the last touched piece is different
+  Game touched = game;
+  touched.setLastTouched(1, 7);
+  ASSERT_NE(touched.getHash(), game.getHash());
+  touched.setLastTouched(1, 21);
+  ASSERT_EQ(touched.getHash(), game.getHash());
+}
+
+TEST(TestGame, UnmakeMovesBackToTheSameGame) {
+  Game game({Player({1, {20, 7, HOME, 20}}), Player({2, {21, HOME, 40, 21}})});
+  game.setLastTouched(1, 7);
+  const Game original = game;
+
+  // A piece of the barrier eats a piece and the piece that was eaten goes
+  // home
+  std::vector<Game::MoveUndo> undos;
+  undos.push_back(game.makeMove({1, 20, 21}));
+  undos.push_back(game.makeMove({2, 21, HOME}));
+  undos.push_back(game.makeMove({1, 21, 41}));
+  ASSERT_EQ(game.getState(), Game(game.getState()).getState());
+  ASSERT_EQ(game.board, Game(game.getState()).board);
+  ASSERT_EQ(game.getHash(), Game(game.getState()).getHash());
+
+  for (auto undo = undos.rbegin(); undo != undos.rend(); undo++) {
+    game.unmakeMove(*undo);
+  }
+  // The pieces are back in the same order
+  ASSERT_EQ(game.getState(), original.getState());
+  ASSERT_EQ(game.board, original.board);
+  ASSERT_EQ(game.getHash(), original.getHash());
+  for (PlayerNumber player = 1; player <= 2; player++) {
+    ASSERT_EQ(game.getPunctuation(player), original.getPunctuation(player));
+  }
+}
+
+TEST(TestGame, HashAfterRandomMovements) {
+  FastRandom random(42);
+  for (unsigned int game = 0; game < 20; game++) {
+    Game played;
+    // Every made move with the hash before it, so it can be unmade
+    std::vector<Game::MoveUndo> undos;
+    std::vector<std::uint64_t> hashes;
+    PlayerNumber player = 1;
+
+    for (unsigned int turn = 0; turn < 100; turn++) {
+      DicePairRoll dices = random.rollDices();
+      std::vector<Game::Turn> turns =
+          played.allPossibleStates(played.getPlayer(player), dices);
+      if (!turns.empty()) {
+        const Game::Turn& chosen = turns[random.below(turns.size())];
+        for (const Move& move : chosen.movements) {
+          hashes.push_back(played.getHash());
+          undos.push_back(played.makeMove(move));
+          ASSERT_EQ(played.getHash(), zobristHash(played.getState()));
+        }
+        ASSERT_EQ(played.getState(), chosen.finalState);
+      }
+
+      // Go back some moves from time to time
+      std::size_t unmade = random.below(4) == 0 ? random.below(4) : 0;
+      for (; unmade > 0 && !undos.empty(); unmade--) {
+        played.unmakeMove(undos.back());
+        undos.pop_back();
+        ASSERT_EQ(played.getHash(), hashes.back());
+        ASSERT_EQ(played.getHash(), zobristHash(played.getState()));
+        hashes.pop_back();
+      }
+
+      if (played.getPlayer(player).hasWon()) break;
+      player = player % 2 + 1;
+    }
+  }
+}
@@ -0,0 +1,21 @@
+#include <gtest/gtest.h>  // for Test, SuiteApiResolver, TestInfo (ptr only)
+
+#include "game_state.hpp"  // for GameState, canonicalKey
+#include "table.hpp"       // for GOAL, HOME
+
+TEST(TestGameState, CanonicalKeyIgnoresTheOrder) {
+  GameState state{{{{HOME, 20, GOAL, 20}, {35, 102, HOME, 7}}}, {20, 7}};
+  GameState sorted{{{{HOME, 20, 20, GOAL}, {HOME, 7, 35, 102}}}, {20, 7}};
+  ASSERT_EQ(canonicalKey(state), canonicalKey(sorted));
+
+  // Same pieces, but other last touched piece
+  GameState touched = state;
+  touched.lastTouched[1] = 35;
+  ASSERT_NE(canonicalKey(state), canonicalKey(touched));
+
+  // Same pieces, but for the other player
+  GameState swapped{{{state.pieces[1], state.pieces[0]}}, {7, 20}};
+  ASSERT_NE(canonicalKey(state), canonicalKey(swapped));
+
+  static_assert(canonicalKey(GameState{}) == 0);
+}
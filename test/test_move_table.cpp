@@ -0,0 +1,55 @@
+#include <gtest/gtest.h>  // for Test, SuiteApiResolver, TestInfo (ptr only)
+
+#include <stdexcept>  // for invalid_argument
+
+#include "dices.hpp"       // for EXTRA_MOVEMENT_ON_GOAL, EXTRA_MOVEMENT_ON_...
+#include "game_state.hpp"  // for N_PLAYERS
+#include "move_table.hpp"  // for getDestination, computeDestination, NO_DE...
+#include "table.hpp"       // for GOAL, HOME, firstHallway, finalHallway
+
+TEST(TestMoveTable, SameAsComputed) {
+  for (PlayerNumber player = 1; player <= N_PLAYERS; player++) {
+    for (Position piece : {HOME, 1u, 30u, 34u, 64u, 68u, firstHallway, GOAL}) {
+      for (unsigned int advance : TABULATED_ADVANCES) {
+        ASSERT_EQ(getDestination(player, piece, advance),
+                  computeDestination(player, piece, advance));
+      }
+    }
+  }
+}
+
+TEST(TestMoveTable, Destinations) {
+  // Exit from home
+  ASSERT_EQ(getDestination(1, HOME, 5), 1);
+  ASSERT_EQ(getDestination(2, HOME, 5), 35);
+  ASSERT_EQ(getDestination(1, HOME, 4), NO_DESTINATION);
+
+  // Cross the position 1
+  ASSERT_EQ(getDestination(2, 66, EXTRA_MOVEMENT_ON_KILL), 18);
+  // Get into the hallway
+  ASSERT_EQ(getDestination(1, 62, 3), firstHallway);
+  ASSERT_EQ(getDestination(1, 62, EXTRA_MOVEMENT_ON_GOAL), GOAL);
+  ASSERT_EQ(getDestination(1, 62, EXTRA_MOVEMENT_ON_KILL), NO_DESTINATION);
+  // Move in the hallway
+  ASSERT_EQ(getDestination(2, finalHallway, 1), GOAL);
+  ASSERT_EQ(getDestination(2, finalHallway, 2), NO_DESTINATION);
+  ASSERT_EQ(getDestination(2, GOAL, 1), NO_DESTINATION);
+
+  // Advances that are not in the table get computed
+  ASSERT_EQ(getDestination(1, 10, 15), 25);
+  ASSERT_EQ(getDestination(1, 62, 15), NO_DESTINATION);
+}
+
+TEST(TestMoveTable, DistanceToGoal) {
+  ASSERT_EQ(getDistanceToGoal(1, GOAL), 0);
+  ASSERT_EQ(getDistanceToGoal(1, finalHallway), 1);
+  ASSERT_EQ(getDistanceToGoal(1, 64), 8);
+  ASSERT_EQ(getDistanceToGoal(2, 30), 8);
+  ASSERT_EQ(getDistanceToGoal(2, 31), 75);
+  // Pieces at home are counted from the initial position
+  ASSERT_EQ(getDistanceToGoal(1, HOME), getDistanceToGoal(1, 1));
+}
+
+TEST(TestMoveTable, ErrorOnWrongPlayer) {
+  EXPECT_THROW(getDestination(0, HOME, 5), std::invalid_argument);
+}
@@ -0,0 +1,151 @@
+#include <gtest/gtest.h>  // for Test, SuiteApiResolver, TestInfo (ptr only)
+
+#include <cstddef>     // for size_t
+#include <filesystem>  // for temp_directory_path, path, remove
+#include <fstream>     // for fstream, ofstream, streamoff
+#include <utility>     // for pair
+#include <vector>      // for vector
+
+#include "dices.hpp"                // for DicePairRoll
+#include "game.hpp"                 // for Game, ScoredPlay, Move
+#include "opening_book.hpp"         // for OpeningBook
+#include "player.hpp"               // for Player
+#include "search_context.hpp"       // for SearchContext
+#include "table.hpp"                // for HOME
+#include "transposition_table.hpp"  // for TranspositionTable
+
+static void comparePlays(const ScoredPlay& play, const ScoredPlay& expected) {
+  ASSERT_EQ(play.score, expected.score);
+  ASSERT_EQ(play.play.size(), expected.play.size());
+  for (std::size_t i = 0; i < play.play.size(); i++) {
+    ASSERT_EQ(play.play[i].player, expected.play[i].player);
+    ASSERT_EQ(play.play[i].origin, expected.play[i].origin);
+    ASSERT_EQ(play.play[i].dest, expected.play[i].dest);
+  }
+}
+
+static std::filesystem::path bookPath() {
+  return std::filesystem::temp_directory_path() / "test_opening_book.bin";
+}
+
+// Changes an entry of the book file in place
+template <typename Change>
+static void corruptEntry(const std::filesystem::path& path, std::size_t index,
+                         Change change) {
+  const std::streamoff offset = static_cast<std::streamoff>(
+      std::filesystem::file_size(path) -
+      (OpeningBook::open(path.string()).size() - index) *
+          sizeof(OpeningBook::Entry));
+  std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+  OpeningBook::Entry entry;
+  file.seekg(offset);
+  file.read(reinterpret_cast<char*>(&entry), sizeof(entry));
+  change(entry);
+  file.seekp(offset);
+  file.write(reinterpret_cast<const char*>(&entry), sizeof(entry));
+}
+
+TEST(TestOpeningBook, WriteAndProbe) {
+  Game opening(Game::Players{Player({1, {HOME, HOME, 5, 6}}),
+                             Player({2, {8, 20, 21, HOME}})});
+  std::vector<std::pair<TranspositionTable::Key, ScoredPlay>> plays;
+  for (DicePairRoll roll : {DicePairRoll{5, 2}, DicePairRoll{3, 3},
+                            DicePairRoll{6, 1}}) {
+    auto key = OpeningBook::key(opening.getState(), 1, roll, 1);
+    plays.push_back({key, opening.bestPlay(1, roll, 1, 1)});
+  }
+
+  std::filesystem::path path = bookPath();
+  OpeningBook::write(path.string(), 1, plays);
+  OpeningBook book = OpeningBook::open(path.string());
+  ASSERT_EQ(book.size(), plays.size());
+  ASSERT_EQ(book.depth(), 1);
+
+  for (const auto& [key, play] : plays) {
+    auto found = book.probe(key);
+    ASSERT_TRUE(found);
+    comparePlays(*found, play);
+  }
+
+  // The depth is not part of the key
+  ASSERT_EQ(OpeningBook::key(opening.getState(), 1, {5, 2}, 1),
+            TranspositionTable::decisionKey(opening.getState(), 1, {5, 2}, 0,
+                                            1));
+  // Other rolls in a row are other decisions
+  ASSERT_FALSE(book.probe(OpeningBook::key(opening.getState(), 1, {5, 2}, 2)));
+
+  std::filesystem::remove(path);
+}
+
+TEST(TestOpeningBook, SearchServedFromTheBook) {
+  Game opening(Game::Players{Player({1, {HOME, HOME, 5, 6}}),
+                             Player({2, {8, 20, 21, HOME}})});
+  DicePairRoll roll{5, 2};
+
+  // A made up play, so it is only found if it comes from the book
+  ScoredPlay stored{{{1, 5, 10}, {1, 6, 8}}, -1234.5};
+  std::filesystem::path path = bookPath();
+  OpeningBook::write(
+      path.string(), 2,
+      {{OpeningBook::key(opening.getState(), 1, roll, 1), stored}});
+  OpeningBook book = OpeningBook::open(path.string());
+
+  TranspositionTable transpositionTable;
+  SearchContext context;
+  context.openingBook = &book;
+  context.transpositionTable = &transpositionTable;
+  opening.setSearchContext(&context);
+  comparePlays(opening.bestPlay(1, roll, 1, 2), stored);
+  // The play was not searched, so it is not cached as if it was
+  ASSERT_FALSE(transpositionTable.probe(TranspositionTable::decisionKey(
+      opening.getState(), 1, roll, 2, 1)));
+  // The searches of other depths are not served, so their inner nodes are
+  // not either
+  comparePlays(opening.bestPlay(1, roll, 1, 1),
+               Game(opening.getState()).bestPlay(1, roll, 1, 1));
+  comparePlays(opening.bestPlay(1, roll, 1, 3),
+               Game(opening.getState()).bestPlay(1, roll, 1, 3));
+  // The rest of decisions are searched
+  comparePlays(opening.bestPlay(1, roll, 2, 1),
+               Game(opening.getState()).bestPlay(1, roll, 2, 1));
+
+  std::filesystem::remove(path);
+}
+
+TEST(TestOpeningBook, InvalidFile) {
+  std::filesystem::path path = bookPath();
+  std::ofstream(path) << "Not a book";
+  ASSERT_THROW(OpeningBook::open(path.string()), OpeningBook::InvalidFile);
+
+  // Truncated book
+  OpeningBook::write(path.string(), 1,
+                     {{TranspositionTable::Key{1, 2}, ScoredPlay{{}, 0}}});
+  std::filesystem::resize_file(path, std::filesystem::file_size(path) - 1);
+  ASSERT_THROW(OpeningBook::open(path.string()), OpeningBook::InvalidFile);
+
+  // A play longer than any turn
+  OpeningBook::write(path.string(), 1,
+                     {{TranspositionTable::Key{1, 2}, ScoredPlay{{}, 0}}});
+  corruptEntry(path, 0, [](OpeningBook::Entry& entry) {
+    entry.nMovements = MAX_TURN_MOVES + 1;
+  });
+  // The entries are only checked when they are probed
+  OpeningBook tooLong = OpeningBook::open(path.string());
+  ASSERT_THROW(tooLong.probe(TranspositionTable::Key{1, 2}),
+               OpeningBook::InvalidFile);
+
+  // Entries out of order
+  OpeningBook::write(path.string(), 1,
+                     {{TranspositionTable::Key{1, 2}, ScoredPlay{{}, 0}},
+                      {TranspositionTable::Key{3, 4}, ScoredPlay{{}, 0}},
+                      {TranspositionTable::Key{5, 6}, ScoredPlay{{}, 0}}});
+  corruptEntry(path, 2, [](OpeningBook::Entry& entry) {
+    entry.key = TranspositionTable::Key{0, 0};
+  });
+  OpeningBook unsorted = OpeningBook::open(path.string());
+  ASSERT_THROW(unsorted.probe(TranspositionTable::Key{3, 4}),
+               OpeningBook::InvalidFile);
+
+  std::filesystem::remove(path);
+  ASSERT_THROW(OpeningBook::open(path.string()), OpeningBook::InvalidFile);
+}
@@ -1,8 +1,10 @@
 #include <gtest/gtest.h>  // for Test, SuiteApiResolver, TestInfo (ptr only)
 
-#include <array>   // for array
-#include <memory>  // for allocator
+#include <array>     // for array
+#include <memory>    // for allocator
+#include <optional>  // for nullopt
 
+#include "board.hpp"   // for SquareMask
 #include "dices.hpp"   // for getDiceValProbability, averageDiceRoll
 #include "player.hpp"  // for Player
 #include "table.hpp"   // for HOME, GOAL, Position, firstHallway, finalHa...
@@ -166,4 +168,43 @@ TEST(TestPlayer, FurtherThanOne) {
     Player::Pieces expectedPositions({GOAL, HOME, HOME, HOME});
     ASSERT_EQ(player.pieces, expectedPositions);
   }
-}
\ No newline at end of file
+}
+TEST(TestPlayer, TryMoveDoesNotThrow) {
+  Player player{1, {HOME, 62, firstHallway + 2, GOAL}};
+  const Player::Pieces initialPositions = player.pieces;
+
+  // Wrong movements leave the pieces untouched
+  EXPECT_EQ(player.tryMovePiece(62, 15), std::nullopt);
+  EXPECT_EQ(player.tryMovePiece(HOME, 1), std::nullopt);
+  EXPECT_EQ(player.tryMovePiece(firstHallway + 2, 10), std::nullopt);
+  EXPECT_EQ(player.tryMovePiece(GOAL, 1), std::nullopt);
+  EXPECT_EQ(player.tryMovePiece(5, 1), std::nullopt);
+  EXPECT_EQ(player.tryMovePiece(62, 1, SquareMask{63}), std::nullopt);
+  ASSERT_EQ(player.pieces, initialPositions);
+
+  // The destination is the same the throwing function gets to
+  EXPECT_EQ(player.destination(62, 2), 64);
+  EXPECT_EQ(player.tryMovePiece(HOME, 5), getPlayerInitialPosition(1));
+  EXPECT_EQ(player.tryMovePiece(62, 10), GOAL);
+  Player::Pieces expectedPositions({1, GOAL, firstHallway + 2, GOAL});
+  ASSERT_EQ(player.pieces, expectedPositions);
+}
+
+TEST(TestPlayer, BarriersOnTheWayToTheHallway) {
+  // The rule: a piece getting into its hallway only crosses the common
+  // positions until the last one of its player, so the barriers past it do
+  // not block the piece
+  Player player1{1, {59, HOME, HOME, HOME}};
+  EXPECT_EQ(player1.destination(59, 6, SquareMask{66}), firstHallway);
+  EXPECT_EQ(player1.destination(59, 6, SquareMask{64}), std::nullopt);
+
+  Player player2{2, {25, HOME, HOME, HOME}};
+  EXPECT_EQ(player2.destination(25, 6, SquareMask{35}), firstHallway);
+  EXPECT_EQ(player2.destination(25, 6, SquareMask{28}), std::nullopt);
+
+  // From the last position the piece only crosses the hallway
+  Player player3{1, {64, HOME, HOME, HOME}};
+  EXPECT_EQ(player3.destination(64, 3, SquareMask{20}), firstHallway + 2);
+  Player player4{2, {30, HOME, HOME, HOME}};
+  EXPECT_EQ(player4.destination(30, 3, SquareMask{20}), firstHallway + 2);
+}
@@ -0,0 +1,73 @@
+#include <gtest/gtest.h>  // for Test, SuiteApiResolver, TestInfo (ptr only)
+
+#include <sstream>  // for istringstream, ostringstream
+#include <string>   // for string, getline
+
+#include "advisor.hpp"          // for Advisor, Query
+#include "game.hpp"             // for Game, ScoredPlay, Move
+#include "player.hpp"           // for Player
+#include "position_stream.hpp"  // for parseQuery, formatPlay, analyzeStream
+#include "table.hpp"            // for GOAL, HOME
+
+TEST(TestPositionStream, ParseQuery) {
+  Query query = parseQuery("2 5 3  0 108 104 60 1 34 35 0");
+
+  ASSERT_EQ(query.player, 2);
+  ASSERT_EQ(query.roll, (DicePairRoll{5, 3}));
+  ASSERT_EQ(query.rollsInARow, 1);
+
+  Game expected({Player({1, {HOME, GOAL, 104, 60}}),
+                 Player({2, {1, 34, 35, HOME}})});
+  ASSERT_EQ(query.state, expected.getState());
+
+  ASSERT_EQ(parseQuery("1 4 4 0 0 0 0 0 0 0 0 2").rollsInARow, 2);
+}
+
+TEST(TestPositionStream, ParseErrors) {
+  // Missing pieces
+  ASSERT_THROW(parseQuery("1 4 4 0 0 0 0"), ParseError);
+  // Wrong player, dices, positions and rolls in a row
+  ASSERT_THROW(parseQuery("3 4 4 0 0 0 0 0 0 0 0"), ParseError);
+  ASSERT_THROW(parseQuery("1 0 4 0 0 0 0 0 0 0 0"), ParseError);
+  ASSERT_THROW(parseQuery("1 4 4 0 0 0 80 0 0 0 0"), ParseError);
+  ASSERT_THROW(parseQuery("1 4 4 0 0 0 -1 0 0 0 0"), ParseError);
+  ASSERT_THROW(parseQuery("1 4 4 0 0 0 0 0 0 0 0 4"), ParseError);
+  // Not numbers or too many of them
+  ASSERT_THROW(parseQuery("one 4 4 0 0 0 0 0 0 0 0"), ParseError);
+  ASSERT_THROW(parseQuery("1 4 4 0 0 0 0 0 0 0 0 1 1"), ParseError);
+}
+
+TEST(TestPositionStream, FormatPlay) {
+  ScoredPlay scoredPlay{{{1, 20, 25}, {2, 25, HOME}}, -12.5};
+  ASSERT_EQ(formatPlay(scoredPlay), "-12.5 1:20-25 2:25-0");
+  ASSERT_EQ(formatPlay({{}, 3}), "3");
+}
+
+TEST(TestPositionStream, AnswersInOrder) {
+  std::istringstream input(
+      "1 1 2 1 34 11 7 105 47 35 41\n"
+      "\n"
+      "not a query\n"
+      "2 5 5 0 0 0 0 0 0 0 0\n");
+  std::ostringstream output;
+
+  Advisor advisor(1, 2);
+  // Small batches so the input is split in several of them
+  analyzeStream(input, output, advisor, {2, 1});
+
+  std::istringstream answers(output.str());
+  std::string answer;
+
+  std::getline(answers, answer);
+  Game first(parseQuery("1 1 2 1 34 11 7 105 47 35 41").state);
+  ASSERT_EQ(answer, formatPlay(first.bestPlay(1, {1, 2}, 1, 1)));
+
+  std::getline(answers, answer);
+  ASSERT_EQ(answer.rfind("error ", 0), 0);
+
+  std::getline(answers, answer);
+  Game second(parseQuery("2 5 5 0 0 0 0 0 0 0 0").state);
+  ASSERT_EQ(answer, formatPlay(second.bestPlay(2, {5, 5}, 1, 1)));
+
+  ASSERT_FALSE(std::getline(answers, answer));
+}
@@ -0,0 +1,37 @@
+#include <gtest/gtest.h>  // for Test, SuiteApiResolver, TestInfo (ptr only)
+
+#include <chrono>  // for milliseconds, operator""ms
+#include <thread>  // for sleep_for
+
+#include "search_budget.hpp"  // for SearchBudget
+
+using namespace std::chrono_literals;
+
+TEST(TestSearchBudget, NodesBudget) {
+  SearchBudget budget(SearchBudget::Clock::duration::zero(), 3);
+
+  for (int i = 0; i < 3; i++) budget.spendNode();
+  ASSERT_FALSE(budget.isExhausted());
+  EXPECT_THROW(budget.spendNode(), SearchBudget::Exhausted);
+  ASSERT_TRUE(budget.isExhausted());
+  // Once spent, it cannot be used until it is restarted
+  EXPECT_THROW(budget.spendNode(), SearchBudget::Exhausted);
+
+  budget.restart();
+  ASSERT_EQ(budget.spentNodes(), 0);
+  EXPECT_NO_THROW(budget.spendNode());
+}
+
+TEST(TestSearchBudget, TimeBudget) {
+  SearchBudget budget(1ms);
+  EXPECT_NO_THROW(budget.spendNode());
+
+  std::this_thread::sleep_for(2ms);
+  EXPECT_THROW(budget.spendNode(), SearchBudget::Exhausted);
+}
+
+TEST(TestSearchBudget, NoLimits) {
+  SearchBudget budget(SearchBudget::Clock::duration::zero());
+  for (int i = 0; i < 1000; i++) budget.spendNode();
+  ASSERT_FALSE(budget.isExhausted());
+}
@@ -0,0 +1,99 @@
+#include <gtest/gtest.h>  // for Test, SuiteApiResolver, TestInfo (ptr only)
+
+#include <cstddef>    // for size_t
+#include <cstdint>    // for uint64_t
+#include <stdexcept>  // for invalid_argument
+#include <vector>     // for vector
+
+#include "game.hpp"         // for Game, Play, Game::Turn
+#include "game_state.hpp"   // for canonicalKey
+#include "player.hpp"       // for Player
+#include "self_play.hpp"    // for simulateGames, playGame, makePolicy, ...
+#include "table.hpp"        // for GOAL
+#include "thread_pool.hpp"  // for ThreadPool
+
+TEST(TestSelfPlay, DicesInRange) {
+  FastRandom random(7);
+  std::size_t doubles = 0;
+  for (unsigned int i = 0; i < 6000; i++) {
+    DicePairRoll dices = random.rollDices();
+    ASSERT_GE(dices.first, 1);
+    ASSERT_LE(dices.first, DICE_FACES);
+    ASSERT_GE(dices.second, 1);
+    ASSERT_LE(dices.second, DICE_FACES);
+    if (dices.first == dices.second) doubles++;
+  }
+
+  // One of every six rolls is a double
+  ASSERT_NEAR(doubles, 1000, 150);
+}
+
+TEST(TestSelfPlay, GamesEndWithAWinner) {
+  Policies policies{randomPolicy(), randomPolicy()};
+  for (std::uint64_t seed = 0; seed < 20; seed++) {
+    GameResult result = playGame(policies, seed);
+    ASSERT_NE(result.winner, 0);
+    ASSERT_GT(result.turns, 0);
+  }
+}
+
+TEST(TestSelfPlay, SameSeedSameReport) {
+  Policies policies{searchPolicy(0), randomPolicy()};
+
+  ThreadPool threadPool(4);
+  SimulationReport sequential = simulateGames(policies, 40, 1234);
+  SimulationReport parallel = simulateGames(policies, 40, 1234, &threadPool);
+
+  ASSERT_EQ(sequential.games, 40);
+  ASSERT_EQ(sequential.wins[0] + sequential.wins[1] + sequential.unfinished,
+            sequential.games);
+  ASSERT_EQ(parallel.wins, sequential.wins);
+  ASSERT_EQ(parallel.totalTurns, sequential.totalTurns);
+  ASSERT_LE(sequential.minTurns, sequential.meanTurns());
+  ASSERT_GE(sequential.maxTurns, sequential.meanTurns());
+}
+
+TEST(TestSelfPlay, SearchBeatsRandom) {
+  Policies policies{searchPolicy(0), randomPolicy()};
+  SimulationReport report = simulateGames(policies, 40, 99);
+
+  ASSERT_GT(report.winRate(1), 0.6);
+}
+
+TEST(TestSelfPlay, SearchPolicyPlaysTheBestPlay) {
+  Game game(Game::Players{Player({1, {1, 34, 11, 7}}),
+                          Player({2, {GOAL - 3, 47, 35, 41}})});
+  DicePairRoll dices{5, 5};
+  FastRandom random(1);
+  Policy policy = searchPolicy(1);
+
+  for (unsigned int rollsInARow = 1; rollsInARow <= 2; rollsInARow++) {
+    std::vector<Game::Turn> turns =
+        game.allPossibleStates(game.getPlayer(1), dices, rollsInARow);
+    std::size_t chosen = policy(game, turns, 1, dices, rollsInARow, random);
+
+    // The turn is the one that gets to the state of the best play
+    Game expected = game;
+    for (const Move& move : game.bestPlay(1, dices, rollsInARow, 1).play) {
+      expected.makeMove(move);
+    }
+    ASSERT_EQ(canonicalKey(turns[chosen].finalState),
+              canonicalKey(expected.getState()));
+  }
+}
+
+TEST(TestSelfPlay, TurnsLimit) {
+  Policies policies{randomPolicy(), randomPolicy()};
+  GameResult result = playGame(policies, 3, 1, 5);
+
+  // The rolls after a double are part of the same turn
+  ASSERT_EQ(result.winner, 0);
+  ASSERT_EQ(result.turns, 5);
+}
+
+TEST(TestSelfPlay, MakePolicy) {
+  ASSERT_TRUE(makePolicy("random"));
+  ASSERT_TRUE(makePolicy("2"));
+  ASSERT_THROW(makePolicy("fast"), std::invalid_argument);
+  ASSERT_THROW(makePolicy("1x"), std::invalid_argument);
+}
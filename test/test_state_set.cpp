@@ -0,0 +1,29 @@
+#include <gtest/gtest.h>  // for Test, SuiteApiResolver, TestInfo (ptr only)
+
+#include <cstdint>  // for uint64_t
+
+#include "state_set.hpp"  // for StateSet
+
+TEST(TestStateSet, InsertOnce) {
+  StateSet set;
+  ASSERT_TRUE(set.insert(0));
+  ASSERT_TRUE(set.insert(42));
+  ASSERT_FALSE(set.insert(0));
+  ASSERT_FALSE(set.insert(42));
+  ASSERT_EQ(set.size(), 2);
+
+  set.clear();
+  ASSERT_EQ(set.size(), 0);
+  ASSERT_TRUE(set.insert(42));
+}
+
+TEST(TestStateSet, GrowsBeyondItsCapacity) {
+  StateSet set(4);
+  for (std::uint64_t key = 0; key < 1000; key++) {
+    ASSERT_TRUE(set.insert(key << 7));
+  }
+  for (std::uint64_t key = 0; key < 1000; key++) {
+    ASSERT_FALSE(set.insert(key << 7));
+  }
+  ASSERT_EQ(set.size(), 1000);
+}
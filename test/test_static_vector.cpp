@@ -0,0 +1,56 @@
+#include <gtest/gtest.h>  // for Test, SuiteApiResolver, TestInfo (ptr only)
+
+#include <iterator>     // for begin, end
+#include <stdexcept>    // for length_error
+#include <type_traits>  // for is_trivially_copyable_v
+
+#include "static_vector.hpp"  // for StaticVector
+
+TEST(TestStaticVector, PushAndPop) {
+  StaticVector<int, 3> vector;
+  ASSERT_TRUE(vector.empty());
+
+  vector.push_back(1);
+  vector.push_back(2);
+  vector.push_back(3);
+  ASSERT_EQ(vector.size(), 3);
+  ASSERT_EQ(vector.front(), 1);
+  ASSERT_EQ(vector.back(), 3);
+  ASSERT_THROW(vector.push_back(4), std::length_error);
+
+  vector.pop_back();
+  ASSERT_EQ(vector.back(), 2);
+
+  int sum = 0;
+  for (int value : vector) sum += value;
+  ASSERT_EQ(sum, 3);
+}
+
+TEST(TestStaticVector, Resize) {
+  StaticVector<int, 3> vector;
+  vector.push_back(5);
+  vector.resize(3);
+  ASSERT_EQ(vector[0], 5);
+  ASSERT_EQ(vector[2], 0);
+
+  vector.resize(1);
+  ASSERT_EQ(vector.size(), 1);
+  ASSERT_THROW(vector.resize(4), std::length_error);
+
+  static_assert(std::is_trivially_copyable_v<StaticVector<int, 3>>);
+}
+
+TEST(TestStaticVector, Assign) {
+  StaticVector<int, 3> vector{1, 2};
+  ASSERT_EQ(vector.size(), 2);
+  ASSERT_EQ(vector.back(), 2);
+
+  const int values[] = {7, 8, 9};
+  vector.assign(std::begin(values), std::end(values));
+  ASSERT_EQ(vector.size(), 3);
+  ASSERT_EQ(vector.front(), 7);
+  ASSERT_THROW((StaticVector<int, 2>{1, 2, 3}), std::length_error);
+
+  // A small capacity keeps the size in a byte
+  static_assert(sizeof(StaticVector<char, 3>) == 4);
+}
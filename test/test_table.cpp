@@ -3,7 +3,7 @@
 #include <memory>     // for allocator
 #include <stdexcept>  // for invalid_argument
 
-#include "table.hpp"  // for distanceToPosition, getPlayerInitialPosition
+#include "table.hpp"  // for distanceToPosition, getPlayerInitialPosition, mirr...
 
 TEST(TableTest, ErrorOnWrongPlayer) {
   EXPECT_THROW(getPlayerInitialPosition(0), std::invalid_argument);
@@ -18,4 +18,16 @@ TEST(TableTest, Distance) {
   EXPECT_THROW(distanceToPosition(GOAL, 1), std::invalid_argument);
   EXPECT_THROW(distanceToPosition(firstHallway, finalHallway),
                std::invalid_argument);
-}
\ No newline at end of file
+}
+TEST(TableTest, MirrorPosition) {
+  ASSERT_EQ(mirrorPosition(1), 35);
+  ASSERT_EQ(mirrorPosition(68), 34);
+  for (Position position = 1; position <= totalPositions; position++) {
+    ASSERT_EQ(mirrorPosition(mirrorPosition(position)), position);
+  }
+
+  // The positions of a single player do not move
+  ASSERT_EQ(mirrorPosition(HOME), HOME);
+  ASSERT_EQ(mirrorPosition(firstHallway), firstHallway);
+  ASSERT_EQ(mirrorPosition(GOAL), GOAL);
+}
@@ -0,0 +1,43 @@
+#include <gtest/gtest.h>  // for Test, SuiteApiResolver, TestInfo (ptr only)
+
+#include <atomic>     // for atomic
+#include <cstddef>    // for size_t
+#include <stdexcept>  // for runtime_error
+#include <vector>     // for vector
+
+#include "thread_pool.hpp"  // for ThreadPool
+
+TEST(TestThreadPool, RunsEveryTaskOnce) {
+  ThreadPool pool(4);
+
+  std::vector<std::atomic<unsigned int>> timesRun(1000);
+  pool.parallelFor(timesRun.size(), [&](std::size_t i) { timesRun[i]++; });
+
+  for (const auto& times : timesRun) ASSERT_EQ(times, 1);
+}
+
+TEST(TestThreadPool, NestedLoops) {
+  ThreadPool pool(2);
+
+  std::atomic<unsigned int> counter{0};
+  pool.parallelFor(10, [&](std::size_t) {
+    pool.parallelFor(10, [&](std::size_t) { counter++; });
+  });
+
+  ASSERT_EQ(counter, 100);
+}
+
+TEST(TestThreadPool, RethrowsExceptions) {
+  ThreadPool pool(2);
+
+  std::atomic<unsigned int> counter{0};
+  EXPECT_THROW(pool.parallelFor(10,
+                                [&](std::size_t i) {
+                                  counter++;
+                                  if (i == 3) throw std::runtime_error("Task");
+                                }),
+               std::runtime_error);
+
+  // The rest of the tasks are still run
+  ASSERT_EQ(counter, 10);
+}
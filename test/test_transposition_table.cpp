@@ -0,0 +1,206 @@
+#include <gtest/gtest.h>  // for Test, SuiteApiResolver, TestInfo (ptr only)
+
+#include <cstddef>  // for size_t
+#include <vector>   // for vector
+
+#include "dices.hpp"                // for DicePairRoll
+#include "game.hpp"                 // for Game, ScoredPlay, Play, mirrorPlay
+#include "game_state.hpp"           // for GameState, mirrorState
+#include "player.hpp"               // for Player
+#include "search_context.hpp"       // for SearchContext
+#include "table.hpp"                // for GOAL, HOME
+#include "transposition_table.hpp"  // for TranspositionTable
+
+static void comparePlays(const Play& play, const Play& expectedPlay) {
+  ASSERT_EQ(play.size(), expectedPlay.size());
+  for (unsigned int i = 0; i < play.size(); i++) {
+    ASSERT_EQ(play[i].player, expectedPlay[i].player);
+    ASSERT_EQ(play[i].origin, expectedPlay[i].origin);
+    ASSERT_EQ(play[i].dest, expectedPlay[i].dest);
+  }
+}
+
+TEST(TestTranspositionTable, SameKeyForPiecesInDifferentOrder) {
+  Game::Players players1{Player({1, {1, 7, HOME, GOAL}}),
+                         Player({2, {HOME, 40, 35, HOME}})};
+  Game::Players players2{Player({1, {GOAL, HOME, 7, 1}}),
+                         Player({2, {35, HOME, HOME, 40}})};
+  Game game1(players1);
+  Game game2(players2);
+  game2.setLastTouched(1, 1);
+  game2.setLastTouched(2, HOME);
+
+  auto key1 = TranspositionTable::chanceKey(game1.getState(), 1, 2, 2, 1);
+  auto key2 = TranspositionTable::chanceKey(game2.getState(), 1, 2, 2, 1);
+  ASSERT_EQ(key1, key2);
+
+  // The depth is part of the key
+  auto key3 = TranspositionTable::chanceKey(game1.getState(), 1, 2, 1, 1);
+  ASSERT_FALSE(key1 == key3);
+
+  // The dices are part of the key
+  auto key4 =
+      TranspositionTable::decisionKey(game1.getState(), 1, {1, 2}, 2, 1);
+  auto key5 =
+      TranspositionTable::decisionKey(game1.getState(), 1, {2, 2}, 2, 1);
+  ASSERT_FALSE(key4 == key5);
+}
+
+TEST(TestTranspositionTable, StoreAndProbe) {
+  TranspositionTable table(16);
+  Game game;
+
+  auto key = TranspositionTable::chanceKey(game.getState(), 1, 2, 1, 1);
+  ASSERT_FALSE(table.probe(key).has_value());
+
+  table.store(key, 1, {{{1, HOME, 1}}, 3.0});
+  auto cached = table.probe(key);
+  ASSERT_TRUE(cached.has_value());
+  ASSERT_DOUBLE_EQ(cached->score, 3.0);
+  ASSERT_EQ(cached->play.size(), 1);
+  ASSERT_EQ(table.hits(), 1);
+  ASSERT_EQ(table.probes(), 2);
+}
+
+TEST(TestTranspositionTable, BoundsOnlyOutOfTheWindow) {
+  TranspositionTable table(16);
+  Game game;
+
+  // The real score is lower or equal than 3
+  auto key = TranspositionTable::chanceKey(game.getState(), 1, 2, 1, 1);
+  table.store(key, 1, {{}, 3.0}, TranspositionTable::Bound::UPPER);
+
+  ASSERT_FALSE(table.probe(key).has_value());
+  ASSERT_FALSE(table.probe(key, {0.0, 10.0}).has_value());
+  auto cached = table.probe(key, {3.0, 10.0});
+  ASSERT_TRUE(cached.has_value());
+  ASSERT_DOUBLE_EQ(cached->score, 3.0);
+
+  // The real score is higher or equal than 3
+  table.store(key, 1, {{}, 3.0}, TranspositionTable::Bound::LOWER);
+  ASSERT_FALSE(table.probe(key, {0.0, 10.0}).has_value());
+  ASSERT_TRUE(table.probe(key, {0.0, 3.0}).has_value());
+}
+
+TEST(TestTranspositionTable, BoundedSize) {
+  TranspositionTable table(8);
+  Game game;
+
+  for (unsigned int depth = 0; depth < 100; depth++) {
+    auto key = TranspositionTable::chanceKey(game.getState(), 1, 2, depth, 1);
+    table.store(key, depth, {{}, static_cast<double>(depth)});
+  }
+
+  ASSERT_LE(table.size(), table.capacity());
+  ASSERT_EQ(table.capacity(), 8);
+}
+
+TEST(TestTranspositionTable, SameBestPlayAsWithoutTable) {
+  std::vector<Game::Players> positions{
+      {Player({1, {1, 34, 11, 7}}), Player({2, {GOAL - 3, 47, 35, 41}})},
+      {Player({1, {GOAL, 2, 1, HOME}}), Player({2, {HOME, 3, 8, HOME}})},
+      {Player({1, {59, 1, 1, HOME}}), Player({2, {HOME, HOME, HOME, 60}})}};
+  // Rolls adding up the same can get to the same states
+  std::vector<DicePairRoll> rolls{{2, 4}, {1, 5}, {5, 5}, {6, 3}};
+
+  std::size_t hits{0};
+  for (const Game::Players& players : positions) {
+    TranspositionTable table;
+    SearchContext context{&table};
+    for (const DicePairRoll& roll : rolls) {
+      Game game(players);
+      ScoredPlay expected = game.bestPlay(1, roll, 1, 1);
+
+      Game cachedGame(players);
+      cachedGame.setSearchContext(&context);
+      ScoredPlay cached = cachedGame.bestPlay(1, roll, 1, 1);
+
+      comparePlays(cached.play, expected.play);
+      ASSERT_DOUBLE_EQ(cached.score, expected.score);
+    }
+    hits += table.hits();
+  }
+
+  // The same positions are reached from different rolls
+  ASSERT_GT(hits, 0);
+}
+
+TEST(TestTranspositionTable, MirroredPositionsShareTheEntries) {
+  Game::Players players{Player({1, {1, 34, 11, 7}}),
+                        Player({2, {GOAL - 3, 47, 35, 41}})};
+  GameState state = Game(players).getState();
+  GameState mirrored = mirrorState(state);
+  ASSERT_EQ(mirrored.getPieces(2)[0], 35);
+  ASSERT_EQ(mirrored.getPieces(1)[0], GOAL - 3);
+  ASSERT_EQ(mirrorState(mirrored), state);
+
+  ASSERT_EQ(TranspositionTable::chanceKey(state, 1, 2, 2, 1),
+            TranspositionTable::chanceKey(mirrored, 2, 1, 2, 1));
+  ASSERT_EQ(TranspositionTable::decisionKey(state, 1, {3, 3}, 2, 2),
+            TranspositionTable::decisionKey(mirrored, 2, {3, 3}, 2, 2));
+  // It is not the same node for the other player
+  ASSERT_FALSE(TranspositionTable::chanceKey(state, 1, 2, 2, 1) ==
+               TranspositionTable::chanceKey(state, 2, 1, 2, 1));
+}
+
+TEST(TestTranspositionTable, MirroredPositionsHaveMirroredPlays) {
+  std::vector<Game::Players> positions{
+      {Player({1, {1, 34, 11, 7}}), Player({2, {GOAL - 3, 47, 35, 41}})},
+      {Player({1, {59, 1, 1, HOME}}), Player({2, {HOME, HOME, HOME, 60}})}};
+  std::vector<DicePairRoll> rolls{{2, 4}, {5, 5}, {6, 3}};
+
+  for (const Game::Players& players : positions) {
+    GameState state = Game(players).getState();
+    TranspositionTable table;
+    SearchContext context{&table};
+
+    for (const DicePairRoll& roll : rolls) {
+      // The search gives the same result from both sides of the board
+      ScoredPlay play = Game(state).bestPlay(1, roll, 1, 1);
+      ScoredPlay mirrored = Game(mirrorState(state)).bestPlay(2, roll, 1, 1);
+      ASSERT_EQ(mirrored.score, play.score);
+      comparePlays(mirrored.play, mirrorPlay(play.play));
+
+      // So what one player stores is found by the other one
+      Game cachedGame(state);
+      cachedGame.setSearchContext(&context);
+      cachedGame.bestPlay(1, roll, 1, 1);
+      std::size_t hits = table.hits();
+      Game mirroredGame(mirrorState(state));
+      mirroredGame.setSearchContext(&context);
+      ScoredPlay cached = mirroredGame.bestPlay(2, roll, 1, 1);
+      ASSERT_EQ(table.hits(), hits + 1);
+      comparePlays(cached.play, mirrored.play);
+      ASSERT_EQ(cached.score, mirrored.score);
+    }
+  }
+}
+
+// State the game gets to with the play
+static GameState stateAfter(const GameState& state, const Play& play) {
+  Game game(state);
+  for (const Move& move : play) game.makeMove(move);
+  return game.getState();
+}
+
+TEST(TestTranspositionTable, MirroredPositionsBreakTiesAlike) {
+  std::vector<Game::Players> positions{
+      {Player({1, {1, 34, 11, 7}}), Player({2, {GOAL - 3, 47, 35, 41}})},
+      {Player({1, {HOME, HOME, 5, 20}}), Player({2, {HOME, 40, 52, HOME}})},
+      {Player({1, {59, 1, 1, HOME}}), Player({2, {HOME, HOME, HOME, 60}})}};
+
+  for (const Game::Players& players : positions) {
+    GameState state = Game(players).getState();
+    for (unsigned int first = 1; first <= 6; first++) {
+      for (unsigned int second = first; second <= 6; second++) {
+        DicePairRoll roll{first, second};
+        // Many turns tie without searching, the same one is chosen from both
+        // sides whatever the order they are generated in
+        Play play = Game(state).bestPlay(1, roll, 1, 0).play;
+        Play mirrored = Game(mirrorState(state)).bestPlay(2, roll, 1, 0).play;
+        ASSERT_EQ(mirrorState(stateAfter(state, play)),
+                  stateAfter(mirrorState(state), mirrored));
+      }
+    }
+  }
+}
@@ -0,0 +1,26 @@
+// Solves the endgames and writes the table the engine loads with --endgame
+#include <exception>  // for exception
+#include <iostream>   // for cerr, cout
+
+#include "dices.hpp"          // for averageDiceRoll
+#include "endgame_table.hpp"  // for EndgameTable
+
+int main(int argc, char* argv[]) {
+  if (argc != 2) {
+    std::cerr << "Usage: " << argv[0] << " <output file>\n";
+    return 1;
+  }
+
+  try {
+    EndgameTable table = EndgameTable::solve();
+    table.save(argv[1]);
+    std::cout << "Solved " << EndgameTable::N_POSITIONS
+              << " endgames, the slowest takes "
+              << table.maxPunctuation() / averageDiceRoll << " rolls\n";
+  } catch (const std::exception& error) {
+    std::cerr << error.what() << "\n";
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,182 @@
+// Plays the first turns of many games, searches the positions that came up
+// the most and writes them to the book the engine loads with --book
+#include <algorithm>  // for min, stable_sort
+#include <cstddef>    // for size_t
+#include <cstdint>    // for uint64_t
+#include <exception>  // for exception
+#include <iostream>   // for cerr, cout
+#include <map>        // for map
+#include <string>     // for string, stoul, stoull
+#include <utility>    // for pair
+#include <vector>     // for vector
+
+#include "advisor.hpp"              // for Advisor, Query
+#include "fast_random.hpp"          // for FastRandom
+#include "game.hpp"                 // for Game, ScoredPlay, mirrorPlay
+#include "opening_book.hpp"         // for OpeningBook
+#include "self_play.hpp"            // for Policy, makePolicy
+#include "table.hpp"                // for PlayerNumber
+#include "transposition_table.hpp"  // for TranspositionTable
+
+struct Options {
+  std::string output;
+  // Games sampled to know which positions are the most frequent
+  std::size_t games{10000};
+  // Dice rolls sampled at the start of every game
+  unsigned int rolls{6};
+  // Positions written to the book
+  std::size_t positions{2000};
+  unsigned int depth{3};
+  unsigned int threads{0};
+  std::uint64_t seed{0};
+  std::string policy{"random"};
+};
+
+struct Candidate {
+  Query query;
+  std::size_t count{0};
+};
+
+using CandidateKey = std::pair<std::uint64_t, std::uint64_t>;
+
+static void printUsage(const char* program) {
+  std::cerr << "Usage: " << program
+            << " <output file> [--games <games>] [--rolls <rolls>]"
+               " [--positions <positions>] [--depth <depth>]"
+               " [--threads <threads>] [--seed <seed>] [--policy <policy>]\n"
+            << "The policy plays the sampled games, \"random\" or the depth "
+               "of the search\n";
+}
+
+// Decisions of the first rolls of the games, with how many times they came up
+static std::map<CandidateKey, Candidate> sampleDecisions(
+    const Options& options) {
+  Policy policy = makePolicy(options.policy);
+  std::map<CandidateKey, Candidate> candidates;
+
+  for (std::size_t i = 0; i < options.games; i++) {
+    FastRandom random(FastRandom(options.seed + i).next());
+    Game game;
+    PlayerNumber player = static_cast<PlayerNumber>(i % N_PLAYERS) + 1;
+    unsigned int rollsInARow = 1;
+
+    for (unsigned int roll = 0; roll < options.rolls; roll++) {
+      DicePairRoll dices = random.rollDices();
+      bool isDouble = dices.first == dices.second;
+      bool isThirdDouble = isDouble && rollsInARow == 3;
+
+      // The third double is not a decision
+      if (!isThirdDouble) {
+        TranspositionTable::Key key =
+            OpeningBook::key(game.getState(), player, dices, rollsInARow);
+        Candidate& candidate = candidates[{key.pieces, key.context}];
+        candidate.query = {game.getState(), player, dices, rollsInARow};
+        candidate.count++;
+      }
+
+      std::vector<Game::Turn> turns =
+          game.allPossibleStates(game.getPlayer(player), dices, rollsInARow);
+      if (!turns.empty()) {
+        std::size_t chosen = 0;
+        if (!isThirdDouble) {
+          chosen = policy(game, turns, player, dices, rollsInARow, random);
+        }
+        game = Game(turns[chosen].finalState);
+      }
+      if (game.getPlayer(player).hasWon()) break;
+
+      if (isDouble && !isThirdDouble) {
+        rollsInARow++;
+      } else {
+        player = player % N_PLAYERS + 1;
+        rollsInARow = 1;
+      }
+    }
+  }
+
+  return candidates;
+}
+
+static int generate(const Options& options) {
+  std::map<CandidateKey, Candidate> candidates = sampleDecisions(options);
+
+  // The most frequent first, the ones with the same frequency in key order
+  std::vector<std::pair<CandidateKey, Candidate>> sorted(candidates.begin(),
+                                                         candidates.end());
+  std::stable_sort(sorted.begin(), sorted.end(),
+                   [](const auto& lhs, const auto& rhs) {
+                     return lhs.second.count > rhs.second.count;
+                   });
+  sorted.resize(std::min(sorted.size(), options.positions));
+
+  std::vector<Query> queries;
+  std::size_t covered{0};
+  for (const auto& [key, candidate] : sorted) {
+    queries.push_back(candidate.query);
+    covered += candidate.count;
+  }
+
+  Advisor advisor(options.depth, options.threads);
+  std::vector<ScoredPlay> plays = advisor.bestPlays(queries);
+
+  // The plays are stored from the side of player 1, as the keys
+  std::vector<std::pair<TranspositionTable::Key, ScoredPlay>> book;
+  for (std::size_t i = 0; i < sorted.size(); i++) {
+    const CandidateKey& key = sorted[i].first;
+    ScoredPlay play = plays[i];
+    if (TranspositionTable::isMirrored(queries[i].player)) {
+      play.play = mirrorPlay(play.play);
+    }
+    book.push_back({{key.first, key.second}, play});
+  }
+  OpeningBook::write(options.output, options.depth, book);
+
+  std::size_t sampled{0};
+  for (const auto& [key, candidate] : candidates) sampled += candidate.count;
+  std::cout << "Searched " << book.size() << " of " << candidates.size()
+            << " positions with depth " << options.depth << ", they are "
+            << covered << " of the " << sampled << " sampled decisions\n";
+  return 0;
+}
+
+int main(int argc, char* argv[]) {
+  if (argc < 2) {
+    printUsage(argv[0]);
+    return 1;
+  }
+
+  Options options;
+  options.output = argv[1];
+  try {
+    for (int i = 2; i < argc; i++) {
+      std::string argument{argv[i]};
+      if (i + 1 >= argc) {
+        printUsage(argv[0]);
+        return 1;
+      }
+      if (argument == "--games") {
+        options.games = std::stoull(argv[++i]);
+      } else if (argument == "--rolls") {
+        options.rolls = std::stoul(argv[++i]);
+      } else if (argument == "--positions") {
+        options.positions = std::stoull(argv[++i]);
+      } else if (argument == "--depth") {
+        options.depth = std::stoul(argv[++i]);
+      } else if (argument == "--threads") {
+        options.threads = std::stoul(argv[++i]);
+      } else if (argument == "--seed") {
+        options.seed = std::stoull(argv[++i]);
+      } else if (argument == "--policy") {
+        options.policy = argv[++i];
+      } else {
+        printUsage(argv[0]);
+        return 1;
+      }
+    }
+
+    return generate(options);
+  } catch (const std::exception& error) {
+    std::cerr << error.what() << "\n";
+    return 1;
+  }
+}